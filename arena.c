@@ -0,0 +1,140 @@
+/**
+ * @file arena.c
+ * @author Eric Watkins, Julian Martinez del Campo, Michael Hnatiw
+ *
+ * This file provides an implementation of arena.h
+ *
+ * Chunks are kept when the arena is reset, so an arena that is reused for
+ * every search stops calling Calloc() once it has grown to the largest
+ * search.
+ */
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+
+#include "arena.h"
+#include "utility.h"
+
+#define ARENA_ALIGN 16
+#define ALIGN( size ) ( ( (size) + ARENA_ALIGN - 1 ) & ~(size_t) ( ARENA_ALIGN - 1 ) )
+
+/** offset of a chunk's memory from the chunk */
+#define CHUNK_HEADER ALIGN( sizeof( struct ArenaChunk ) )
+
+/**
+ * Create a new chunk
+ *
+ * @param capacity the bytes the chunk holds
+ * @return a new empty chunk, or null if the memory limit is reached
+ */
+static struct ArenaChunk * new_chunk( size_t capacity )
+{
+    struct ArenaChunk * chunk = Calloc( 1, CHUNK_HEADER + capacity );
+
+    if( chunk != NULL )
+        chunk->capacity = capacity;
+
+    return chunk;
+}
+
+/**
+ * Create a new arena
+ *
+ * @param chunk_size the size of the arena's chunks, in bytes
+ * @return a new empty arena
+ */
+struct Arena * new_arena( size_t chunk_size )
+{
+    struct Arena * arena = Calloc( 1, sizeof( struct Arena ) );
+    assert( arena );
+
+    arena->chunk_size = ALIGN( chunk_size );
+    arena->first = new_chunk( arena->chunk_size );
+    assert( arena->first );
+    arena->current = arena->first;
+
+    return arena;
+}
+
+/**
+ * Delete an arena and everything allocated from it
+ *
+ * @param arena an arena to destroy
+ */
+void delete_arena( struct Arena ** arena )
+{
+    struct ArenaChunk * chunk = (*arena)->first;
+
+    while( chunk != NULL )
+    {
+        struct ArenaChunk * next = chunk->next;
+        Free( chunk );
+        chunk = next;
+    }
+
+    Free( *arena );
+    *arena = NULL;
+}
+
+/**
+ * Allocate zeroed memory from an arena
+ *
+ * @param arena an arena
+ * @param size the bytes needed
+ * @return the memory, or null if the memory limit is reached
+ */
+void * arena_alloc( struct Arena * arena, size_t size )
+{
+    struct ArenaChunk * chunk = arena->current;
+
+    size = ALIGN( size );
+
+    /* move on to a chunk with room, making one if there is none */
+    while( chunk->used + size > chunk->capacity )
+    {
+        if( chunk->next == NULL || chunk->next->capacity < size )
+        {
+            struct ArenaChunk * added =
+                new_chunk( size > arena->chunk_size ? size : arena->chunk_size );
+            if( added == NULL )
+                return NULL;
+
+            added->next = chunk->next;
+            chunk->next = added;
+        }
+
+        chunk = chunk->next;
+        chunk->used = 0;
+    }
+
+    arena->current = chunk;
+
+    void * memory = (char *) chunk + CHUNK_HEADER + chunk->used;
+    chunk->used += size;
+    arena->used += size;
+
+    return memset( memory, 0, size );
+}
+
+/**
+ * Give back everything allocated from an arena
+ *
+ * @param arena an arena
+ */
+void reset_arena( struct Arena * arena )
+{
+    arena->first->used = 0;
+    arena->current = arena->first;
+    arena->used = 0;
+}
+
+/**
+ * Get the memory in use in an arena
+ *
+ * @param arena an arena
+ * @return the bytes handed out since the last reset
+ */
+size_t arena_used( const struct Arena * arena )
+{
+    return arena->used;
+}
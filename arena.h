@@ -0,0 +1,38 @@
+/**
+ * @file arena.h
+ * @author Eric Watkins, Julian Martinez del Campo, Michael Hnatiw
+ *
+ * This file provides an arena: memory handed out by bumping a pointer and
+ * given back all at once by resetting the arena
+ */
+#ifndef _ARENA_H_
+#define _ARENA_H_
+
+#include <stddef.h>
+
+/** default size of an arena's chunks, in bytes */
+#define ARENA_CHUNK_SIZE ( 64 * 1024 )
+
+/** a block of arena memory */
+struct ArenaChunk {
+    struct ArenaChunk * next;   /**< next chunk, or null */
+    size_t capacity;            /**< bytes the chunk holds */
+    size_t used;                /**< bytes handed out */
+};
+
+/** an arena of chunks from Calloc() */
+struct Arena {
+    struct ArenaChunk * first;  /**< first chunk */
+    struct ArenaChunk * current;/**< chunk allocations come from */
+    size_t chunk_size;          /**< size of new chunks */
+    size_t used;                /**< bytes handed out since the last reset */
+};
+
+struct Arena * new_arena( size_t chunk_size );
+void delete_arena( struct Arena ** arena );
+
+void * arena_alloc( struct Arena * arena, size_t size );
+void reset_arena( struct Arena * arena );
+size_t arena_used( const struct Arena * arena );
+
+#endif /* _ARENA_H_ */
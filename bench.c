@@ -0,0 +1,87 @@
+/**
+ * @file bench.c
+ * @author Eric Watkins, Julian Martinez del Campo, Michael Hnatiw
+ *
+ * Measure how the search scales with threads: the time to search a position
+ * to a fixed depth with 1, 2, 4 and so on threads, sharing the table (lazy
+ * SMP) or splitting the tree (young brothers wait).
+ */
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <ctype.h>
+#include <string.h>
+#include <limits.h>
+
+#include "konane.h"
+#include "state.h"
+#include "move.h"
+#include "game_node.h"
+#include "arena.h"
+#include "clock.h"
+#include "utility.h"
+
+int main( int argc, char * argv[] )
+{
+    if( argc < 4 || argc > 6 )
+    {
+        printf( "%s usage: <input file> <player color> <depth> [max threads] [ybw]\n", argv[ 0 ] );
+        printf( "   input file - a text file consisting of a konane board\n" );
+        printf( "   player color - B or W, the player to move\n" );
+        printf( "   depth - the number of plies to search, at least 1\n" );
+        printf( "   max threads - the most threads to search with, doubling from 1\n" );
+        printf( "   ybw - split the tree between the threads instead of lazy SMP\n" );
+        return EXIT_FAILURE;
+    }
+
+    char board[ SIZE ][ SIZE ];
+    int depth = atoi( argv[ 3 ] );
+    int max_threads = ( argc >= 5 ) ? atoi( argv[ 4 ] ) : 1;
+    double base = 0;
+
+    if( depth < 1 || max_threads < 1 )
+    {
+        printf( "depth and max threads must be at least 1\n" );
+        return EXIT_FAILURE;
+    }
+
+    /* set up board */
+    setup_board( argv[ 1 ], board );
+    struct State * state = new_state( board, toupper( argv[ 2 ][ 0 ] ) );
+
+    struct Arena * arena = new_arena( ARENA_CHUNK_SIZE );
+
+    /* only the depth ends a run, never the time per move */
+    set_search_depth( depth );
+    set_move_time( LLONG_MAX / 2 );
+    set_search_split( argc == 6 && strcmp( argv[ 5 ], "ybw" ) == 0 );
+    printf( "%8s %6s %10s %8s\n", "Threads", "Depth", "Time (s)", "Speedup" );
+
+    for( int threads = 1; threads <= max_threads; threads *= 2 )
+    {
+        struct GameNode * root = new_game_node( arena, state, NULL );
+
+        /* every run starts cold, with nothing learned by the run before */
+        reset_search();
+        set_search_threads( threads );
+
+        millis start = clock_ms();
+        alpha_beta_search( root );
+        double elapsed = ( clock_ms() - start ) / 1000.0;
+
+        if( threads == 1 )
+            base = elapsed;
+
+        printf( "%8d %6d %10.3f %8.2f\n", threads, root->depth, elapsed,
+                ( elapsed > 0 ) ? base / elapsed : 0.0 );
+
+        Free( root->best_move );
+        reset_arena( arena );
+    }
+
+    delete_arena( &arena );
+    Free( state );
+
+    return EXIT_SUCCESS;
+}
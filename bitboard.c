@@ -0,0 +1,30 @@
+/**
+ * @file bitboard.c
+ * @author Eric Watkins, Julian Martinez del Campo, Michael Hnatiw
+ *
+ * This file provides an implementation of bitboard.h
+ */
+#include "bitboard.h"
+
+/** square index offset of one step in each direction */
+const int direction_offset[ DIRECTIONS ] = { 1, -1, SIZE, -SIZE };
+
+/**
+ * Move every square of a mask by a symmetry
+ *
+ * @param b a mask
+ * @param symmetry a symmetry
+ * @return the mask's image
+ */
+bitboard transform_board( bitboard b, int symmetry )
+{
+    bitboard image = BB_EMPTY;
+
+    if( symmetry == IDENTITY )
+        return b;
+
+    while( !bb_none( b ) )
+        image = bb_or( image, bb_square( symmetric_square( pop_square( &b ), symmetry ) ) );
+
+    return image;
+}
@@ -0,0 +1,394 @@
+/**
+ * @file bitboard.h
+ * @author Eric Watkins, Julian Martinez del Campo, Michael Hnatiw
+ *
+ * This file provides occupancy masks for a konane board. Square (row, col)
+ * is bit row * SIZE + col, so row 0 is the low bits.
+ *
+ * The board size SIZE is fixed when a module is built, so every mask
+ * operation compiles down to constants for that size. The modules are built
+ * once per board size, see sizes.h. Boards up to 8x8 use 64-bit masks, up
+ * to 10x10 128-bit masks, and larger ones an array of 64-bit words. Masks
+ * are only combined through the bb_ functions below, which are the C
+ * operators on the integer masks and loops over the words otherwise.
+ */
+#ifndef _BITBOARD_H_
+#define _BITBOARD_H_
+
+#include <stdint.h>
+
+#ifndef SIZE
+#define SIZE 8
+#endif
+
+#if SIZE < 4 || SIZE > 16 || SIZE % 2 != 0
+#error "SIZE must be an even board size from 4 to 16"
+#endif
+
+#define BB_INDEX( row, col )    ( (row) * SIZE + (col) )
+#define BB_SQUARE( row, col )   bb_square( BB_INDEX( row, col ) )
+
+#if SIZE * SIZE <= 128
+
+/** an occupancy mask, one bit per square */
+#if SIZE * SIZE <= 64
+typedef uint64_t bitboard;
+#else
+__extension__ typedef unsigned __int128 bitboard;
+#endif
+
+#define BB_EMPTY        ((bitboard) 0)
+#define BB_ONE          ((bitboard) 1)
+#if SIZE * SIZE == 64
+#define BB_ALL          (~BB_EMPTY)
+#else
+#define BB_ALL          ((BB_ONE << (SIZE * SIZE)) - 1)
+#endif
+#define BB_FIRST_COL    (BB_ALL / ((BB_ONE << SIZE) - 1))
+#define BB_LAST_COL     (BB_FIRST_COL << (SIZE - 1))
+
+static inline bitboard bb_word( uint64_t word ) { return word; }
+static inline bitboard bb_square( int square ) { return BB_ONE << square; }
+static inline int bb_test( bitboard b, int square ) { return ( b >> square ) & 1; }
+static inline int bb_none( bitboard b ) { return b == 0; }
+static inline int bb_equal( bitboard a, bitboard b ) { return a == b; }
+static inline bitboard bb_and( bitboard a, bitboard b ) { return a & b; }
+static inline bitboard bb_or( bitboard a, bitboard b ) { return a | b; }
+static inline bitboard bb_xor( bitboard a, bitboard b ) { return a ^ b; }
+static inline bitboard bb_andnot( bitboard a, bitboard b ) { return a & ~b; }
+static inline bitboard bb_shl( bitboard b, int n ) { return b << n; }
+static inline bitboard bb_shr( bitboard b, int n ) { return b >> n; }
+
+/**
+ * Read some bits of a mask
+ *
+ * @param b a mask
+ * @param start the first square
+ * @param count the number of squares, at most 64
+ * @return the squares from start on, start in bit 0
+ */
+static inline uint64_t bb_bits( bitboard b, int start, int count )
+{
+    uint64_t bits = (uint64_t) ( b >> start );
+
+    return ( count < 64 ) ? bits & ( ( (uint64_t) 1 << count ) - 1 ) : bits;
+}
+
+#else
+
+#define BB_WORDS ( ( SIZE * SIZE + 63 ) / 64 )
+
+/** an occupancy mask, one bit per square, square n in bit n % 64 of word n / 64 */
+typedef struct {
+    uint64_t w[ BB_WORDS ];
+} bitboard;
+
+/* the words of the constant masks, worked out at compile time */
+#define BB_ALL_WORD( w ) \
+    ( ( SIZE * SIZE >= 64 * ( (w) + 1 ) ) ? ~(uint64_t) 0 \
+                                          : ( (uint64_t) 1 << ( ( SIZE * SIZE - 64 * (w) ) & 63 ) ) - 1 )
+#define BB_COL_BIT( w, row, col ) \
+    ( ( (row) < SIZE && BB_INDEX( row, col ) / 64 == (w) ) ? (uint64_t) 1 << ( BB_INDEX( row, col ) % 64 ) : 0 )
+#define BB_COL_WORD( w, col ) \
+    ( BB_COL_BIT( w, 0, col ) | BB_COL_BIT( w, 1, col ) | BB_COL_BIT( w, 2, col ) | BB_COL_BIT( w, 3, col ) | \
+      BB_COL_BIT( w, 4, col ) | BB_COL_BIT( w, 5, col ) | BB_COL_BIT( w, 6, col ) | BB_COL_BIT( w, 7, col ) | \
+      BB_COL_BIT( w, 8, col ) | BB_COL_BIT( w, 9, col ) | BB_COL_BIT( w, 10, col ) | BB_COL_BIT( w, 11, col ) | \
+      BB_COL_BIT( w, 12, col ) | BB_COL_BIT( w, 13, col ) | BB_COL_BIT( w, 14, col ) | BB_COL_BIT( w, 15, col ) )
+#define BB_FIRST_COL_WORD( w )  BB_COL_WORD( w, 0 )
+#define BB_LAST_COL_WORD( w )   BB_COL_WORD( w, SIZE - 1 )
+
+#if BB_WORDS == 3
+#define BB_WORDS_OF( WORD ) ( (bitboard) { { WORD( 0 ), WORD( 1 ), WORD( 2 ) } } )
+#else
+#define BB_WORDS_OF( WORD ) ( (bitboard) { { WORD( 0 ), WORD( 1 ), WORD( 2 ), WORD( 3 ) } } )
+#endif
+
+#define BB_EMPTY        ( (bitboard) { { 0 } } )
+#define BB_ALL          BB_WORDS_OF( BB_ALL_WORD )
+#define BB_FIRST_COL    BB_WORDS_OF( BB_FIRST_COL_WORD )
+#define BB_LAST_COL     BB_WORDS_OF( BB_LAST_COL_WORD )
+
+static inline bitboard bb_word( uint64_t word )
+{
+    bitboard b = BB_EMPTY;
+    b.w[ 0 ] = word;
+    return b;
+}
+
+static inline bitboard bb_square( int square )
+{
+    bitboard b = BB_EMPTY;
+    b.w[ square / 64 ] = (uint64_t) 1 << ( square % 64 );
+    return b;
+}
+
+static inline int bb_test( bitboard b, int square )
+{
+    return ( b.w[ square / 64 ] >> ( square % 64 ) ) & 1;
+}
+
+static inline int bb_none( bitboard b )
+{
+    uint64_t any = 0;
+    for( int i = 0; i < BB_WORDS; i++ )
+        any |= b.w[ i ];
+    return any == 0;
+}
+
+static inline int bb_equal( bitboard a, bitboard b )
+{
+    uint64_t differ = 0;
+    for( int i = 0; i < BB_WORDS; i++ )
+        differ |= a.w[ i ] ^ b.w[ i ];
+    return differ == 0;
+}
+
+static inline bitboard bb_and( bitboard a, bitboard b )
+{
+    for( int i = 0; i < BB_WORDS; i++ )
+        a.w[ i ] &= b.w[ i ];
+    return a;
+}
+
+static inline bitboard bb_or( bitboard a, bitboard b )
+{
+    for( int i = 0; i < BB_WORDS; i++ )
+        a.w[ i ] |= b.w[ i ];
+    return a;
+}
+
+static inline bitboard bb_xor( bitboard a, bitboard b )
+{
+    for( int i = 0; i < BB_WORDS; i++ )
+        a.w[ i ] ^= b.w[ i ];
+    return a;
+}
+
+static inline bitboard bb_andnot( bitboard a, bitboard b )
+{
+    for( int i = 0; i < BB_WORDS; i++ )
+        a.w[ i ] &= ~b.w[ i ];
+    return a;
+}
+
+/**
+ * Shift a mask towards higher squares, carrying bits between the words
+ *
+ * @param b a mask
+ * @param n the squares to shift by, from 0 to SIZE * SIZE
+ * @return the shifted mask, which may hold bits past the last square
+ */
+static inline bitboard bb_shl( bitboard b, int n )
+{
+    bitboard shifted = BB_EMPTY;
+    int words = n / 64;
+    int bits = n % 64;
+
+    for( int i = BB_WORDS - 1; i >= words; i-- )
+    {
+        shifted.w[ i ] = b.w[ i - words ] << bits;
+        if( bits > 0 && i - words > 0 )
+            shifted.w[ i ] |= b.w[ i - words - 1 ] >> ( 64 - bits );
+    }
+
+    return shifted;
+}
+
+/**
+ * Shift a mask towards lower squares, carrying bits between the words
+ *
+ * @param b a mask
+ * @param n the squares to shift by, from 0 to SIZE * SIZE
+ * @return the shifted mask
+ */
+static inline bitboard bb_shr( bitboard b, int n )
+{
+    bitboard shifted = BB_EMPTY;
+    int words = n / 64;
+    int bits = n % 64;
+
+    for( int i = 0; i + words < BB_WORDS; i++ )
+    {
+        shifted.w[ i ] = b.w[ i + words ] >> bits;
+        if( bits > 0 && i + words + 1 < BB_WORDS )
+            shifted.w[ i ] |= b.w[ i + words + 1 ] << ( 64 - bits );
+    }
+
+    return shifted;
+}
+
+/**
+ * Read some bits of a mask
+ *
+ * @param b a mask
+ * @param start the first square
+ * @param count the number of squares, at most 64
+ * @return the squares from start on, start in bit 0
+ */
+static inline uint64_t bb_bits( bitboard b, int start, int count )
+{
+    uint64_t bits = bb_shr( b, start ).w[ 0 ];
+
+    return ( count < 64 ) ? bits & ( ( (uint64_t) 1 << count ) - 1 ) : bits;
+}
+
+#endif
+
+/** jump directions */
+enum Direction {
+    RIGHT = 0,  /**< increasing column */
+    LEFT,       /**< decreasing column */
+    DOWN,       /**< increasing row */
+    UP,         /**< decreasing row */
+    DIRECTIONS  /**< number of directions */
+};
+
+/** square index offset of one step in each direction */
+extern const int direction_offset[ DIRECTIONS ];
+
+/**
+ * Symmetries of the board that keep every square on its colour, so a
+ * position and its image are the same game. Each undoes itself.
+ */
+enum Symmetry {
+    IDENTITY = 0,       /**< leaves the board as it is */
+    ROTATE_HALF,        /**< turns the board half way round */
+    FLIP_DIAGONAL,      /**< swaps rows and columns */
+    FLIP_ANTIDIAGONAL,  /**< swaps rows and columns, counting from the far edges */
+    SYMMETRIES          /**< number of symmetries */
+};
+
+bitboard transform_board( bitboard b, int symmetry );
+
+/**
+ * Find where a symmetry moves a square
+ *
+ * @param square a square index
+ * @param symmetry a symmetry
+ * @return the index of the square's image
+ */
+static inline int symmetric_square( int square, int symmetry )
+{
+    int row = square / SIZE;
+    int col = square % SIZE;
+
+    switch( symmetry )
+    {
+    case ROTATE_HALF:
+        return BB_INDEX( SIZE - 1 - row, SIZE - 1 - col );
+    case FLIP_DIAGONAL:
+        return BB_INDEX( col, row );
+    case FLIP_ANTIDIAGONAL:
+        return BB_INDEX( SIZE - 1 - col, SIZE - 1 - row );
+    default:
+        return square;
+    }
+}
+
+/**
+ * Shift every square of a mask one step in a direction, dropping squares
+ * that would leave the board
+ *
+ * @param b a mask
+ * @param direction the direction to shift in
+ * @return the shifted mask
+ */
+static inline bitboard shift( bitboard b, int direction )
+{
+    switch( direction )
+    {
+    case RIGHT:
+        return bb_andnot( bb_and( bb_shl( b, 1 ), BB_ALL ), BB_FIRST_COL );
+    case LEFT:
+        return bb_andnot( bb_shr( b, 1 ), BB_LAST_COL );
+    case DOWN:
+        return bb_and( bb_shl( b, SIZE ), BB_ALL );
+    default:
+        return bb_shr( b, SIZE );
+    }
+}
+
+/**
+ * Find the landing squares of single jumps
+ *
+ * @param from squares that may jump
+ * @param over squares that may be jumped
+ * @param empty empty squares
+ * @param direction the direction to jump in
+ * @return the squares reached by jumping from a square in from, over a
+ *  square in over, onto a square in empty
+ */
+static inline bitboard jumps( bitboard from, bitboard over, bitboard empty, int direction )
+{
+    return bb_and( shift( bb_and( shift( from, direction ), over ), direction ), empty );
+}
+
+/**
+ * Count the squares in a mask
+ *
+ * @param b a mask
+ * @return the number of set squares
+ */
+static inline int popcount( bitboard b )
+{
+#if SIZE * SIZE > 128
+    int count = 0;
+    for( int i = 0; i < BB_WORDS; i++ )
+#if defined( __GNUC__ )
+        count += __builtin_popcountll( b.w[ i ] );
+#else
+        for( uint64_t word = b.w[ i ]; word; word &= word - 1 )
+            count++;
+#endif
+    return count;
+#elif defined( __GNUC__ ) && SIZE * SIZE <= 64
+    return __builtin_popcountll( b );
+#elif defined( __GNUC__ )
+    return __builtin_popcountll( (uint64_t) b ) + __builtin_popcountll( (uint64_t) ( b >> 64 ) );
+#else
+    int count = 0;
+    for( ; b; b &= b - 1 )
+        count++;
+    return count;
+#endif
+}
+
+/**
+ * Remove the lowest square from a mask
+ *
+ * @pre *b is not empty
+ * @param b a mask to take a square from
+ * @return the index of the square removed
+ */
+static inline int pop_square( bitboard * b )
+{
+#if SIZE * SIZE > 128
+    int i = 0;
+    while( b->w[ i ] == 0 )
+        i++;
+#if defined( __GNUC__ )
+    int square = 64 * i + __builtin_ctzll( b->w[ i ] );
+#else
+    int square = 64 * i;
+    while( !( ( b->w[ i ] >> ( square % 64 ) ) & 1 ) )
+        square++;
+#endif
+    b->w[ i ] &= b->w[ i ] - 1;
+    return square;
+#else
+#if defined( __GNUC__ ) && SIZE * SIZE <= 64
+    int square = __builtin_ctzll( *b );
+#elif defined( __GNUC__ )
+    uint64_t low = (uint64_t) *b;
+    int square = low ? __builtin_ctzll( low ) : 64 + __builtin_ctzll( (uint64_t) ( *b >> 64 ) );
+#else
+    int square = 0;
+    while( !( ( *b >> square ) & 1 ) )
+        square++;
+#endif
+    *b &= *b - 1;
+    return square;
+#endif
+}
+
+#endif /* _BITBOARD_H_ */
@@ -0,0 +1,111 @@
+/**
+ * @file book.c
+ * @author Eric Watkins, Julian Martinez del Campo, Michael Hnatiw
+ *
+ * This file provides an implementation of book.h
+ *
+ * The file is mapped read only and its entries are sorted by key, so a
+ * probe is a binary search over the mapped pages.
+ */
+#define _POSIX_C_SOURCE 200809L
+
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "book.h"
+#include "symmetry.h"
+
+/** the mapped file, or null */
+static const unsigned char * book = NULL;
+static size_t book_length = 0;
+
+/** the entries of the mapped file */
+static const struct BookEntry * entries = NULL;
+static size_t entry_count = 0;
+
+/**
+ * Map an opening book into memory
+ *
+ * @param path the book file written by bookgen
+ * @return 1 if the book was loaded, -1 if it was built for another board
+ * size, else return 0
+ */
+int load_book( const char * path )
+{
+    struct BookHeader header;
+    struct stat status;
+    int fd = open( path, O_RDONLY );
+
+    if( fd < 0 )
+        return 0;
+
+    if( fstat( fd, &status ) != 0 ||
+        read( fd, &header, sizeof( header ) ) != sizeof( header ) ||
+        memcmp( header.magic, BOOK_MAGIC, sizeof( header.magic ) ) != 0 ||
+        header.count < 0 ||
+        (size_t) status.st_size != sizeof( header ) + header.count * sizeof( struct BookEntry ) )
+    {
+        close( fd );
+        return 0;
+    }
+
+    if( header.size != SIZE )
+    {
+        close( fd );
+        return -1;
+    }
+
+    void * map = mmap( NULL, status.st_size, PROT_READ, MAP_PRIVATE, fd, 0 );
+    close( fd );
+    if( map == MAP_FAILED )
+        return 0;
+
+    if( book != NULL )
+        munmap( (void *) book, book_length );
+
+    book = map;
+    book_length = status.st_size;
+    entries = (const struct BookEntry *) ( book + sizeof( header ) );
+    entry_count = header.count;
+
+    return 1;
+}
+
+/**
+ * Look a position up in the opening book
+ *
+ * A position shares its entry with its mirror images.
+ *
+ * @param state a state
+ * @param entry set to the position's entry, its move turned to the state's
+ *  orientation
+ * @return 1 if the position is in the book, else return 0
+ */
+int probe_book( const struct State * state, struct BookEntry * entry )
+{
+    int symmetry;
+    uint64_t key = canonical_key( state, &symmetry );
+    size_t low = 0;
+    size_t high = entry_count;
+
+    while( low < high )
+    {
+        size_t middle = low + ( high - low ) / 2;
+
+        if( entries[ middle ].key < key )
+            low = middle + 1;
+        else
+            high = middle;
+    }
+
+    if( low >= entry_count || entries[ low ].key != key )
+        return 0;
+
+    *entry = entries[ low ];
+    transform_move( &entry->move, symmetry );
+
+    return 1;
+}
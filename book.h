@@ -0,0 +1,39 @@
+/**
+ * @file book.h
+ * @author Eric Watkins, Julian Martinez del Campo, Michael Hnatiw
+ *
+ * This file provides an opening book: the best move and score of the
+ * positions of the first plies, worked out ahead of time by bookgen and
+ * mapped into memory by the engine
+ */
+#ifndef _BOOK_H_
+#define _BOOK_H_
+
+#include <stdint.h>
+
+#include "state.h"
+#include "move.h"
+
+#define BOOK_MAGIC "KONBK03"
+
+/** the start of a book file, followed by the entries sorted by key */
+struct BookHeader {
+    char magic[ 8 ];    /**< BOOK_MAGIC */
+    int32_t count;      /**< number of entries */
+    int32_t plies;      /**< plies of the game the book covers */
+    int32_t size;       /**< SIZE of the board the book was built for */
+};
+
+/** a position of the book */
+struct BookEntry {
+    uint64_t key;       /**< canonical_key() of the position */
+    struct Move move;   /**< best move in the canonical orientation, a removal
+                             has the same start and end */
+    int32_t score;      /**< score of the move for the player to move */
+    int32_t depth;      /**< plies the move was searched to */
+};
+
+int load_book( const char * path );
+int probe_book( const struct State * state, struct BookEntry * entry );
+
+#endif /* _BOOK_H_ */
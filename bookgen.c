@@ -0,0 +1,267 @@
+/**
+ * @file bookgen.c
+ * @author Eric Watkins, Julian Martinez del Campo, Michael Hnatiw
+ *
+ * Generate an opening book: search every position of the first plies of
+ * the game, both removals included, and write the best move and score of
+ * each, sorted by key.
+ */
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "book.h"
+#include "symmetry.h"
+#include "konane.h"
+#include "state.h"
+#include "move.h"
+#include "game_node.h"
+#include "arena.h"
+#include "clock.h"
+#include "utility.h"
+
+#define LOST_SCORE -10000      /* score of a position with no move, as a lost endgame */
+
+/** the entries found so far, in the order they were searched */
+static struct BookEntry * book = NULL;
+static int book_count = 0;
+static int book_capacity = 0;
+
+/** arena of the search trees */
+static struct Arena * arena = NULL;
+
+/**
+ * Find a position among the entries found so far
+ *
+ * @param key the position's key
+ * @return its entry, or null
+ */
+static struct BookEntry * find_entry( uint64_t key )
+{
+    for( int i = 0; i < book_count; i++ )
+        if( book[ i ].key == key )
+            return &book[ i ];
+
+    return NULL;
+}
+
+/**
+ * Add a position to the book
+ *
+ * @param entry the position's entry
+ */
+static void add_entry( const struct BookEntry * entry )
+{
+    if( book_count == book_capacity )
+    {
+        int capacity = book_capacity ? 2 * book_capacity : 256;
+        struct BookEntry * grown = Calloc( capacity, sizeof( struct BookEntry ) );
+        if( grown == NULL )
+        {
+            printf( "not enough memory for %d entries\n", capacity );
+            exit( EXIT_FAILURE );
+        }
+
+        if( book != NULL )
+        {
+            memcpy( grown, book, book_count * sizeof( struct BookEntry ) );
+            Free( book );
+        }
+        book = grown;
+        book_capacity = capacity;
+    }
+
+    book[ book_count++ ] = *entry;
+}
+
+/**
+ * Search a position with the engine
+ *
+ * @param state a state whose player has a move
+ * @param entry set to the position's best move, in the state's
+ *  orientation, and score
+ */
+static void search_position( const struct State * state, struct BookEntry * entry )
+{
+    struct State root_state = *state;
+    struct GameNode * root = new_game_node( arena, &root_state, NULL );
+
+    alpha_beta_search( root );
+
+    entry->move = root->pv[ 0 ];
+    entry->score = root->best_util_val;
+    entry->depth = root->depth;
+
+    Free( root->best_move );
+    reset_arena( arena );
+}
+
+/**
+ * Score a position, adding it and the positions after it to the book
+ *
+ * A removal is scored by the positions it leads to, as the search cannot
+ * play removals. Every position is searched once, however it is reached
+ * and whichever way it is turned.
+ *
+ * @param state a state
+ * @param plies the plies still to add to the book from the state
+ * @param depth set to the plies the score was searched to
+ * @return the score for the player to move
+ */
+static int build( const struct State * state, int plies, int * depth )
+{
+    struct BookEntry entry = { 0 };
+    int symmetry;
+    uint64_t key = canonical_key( state, &symmetry );
+    struct BookEntry * found = find_entry( key );
+
+    if( found != NULL )
+    {
+        *depth = found->depth;
+        return found->score;
+    }
+
+    if( popcount( empty_squares( state ) ) <= 1 )
+    {
+        struct Move moves[ MAX_REMOVALS ];
+        int count = removals( state, moves );
+
+        entry.score = LOST_SCORE;
+        for( int i = 0; i < count; i++ )
+        {
+            struct State after = *state;
+            set_piece( &after, moves[ i ].start_row, moves[ i ].start_col, 'O' );
+            after.player = opposite_player( state->player );
+
+            int after_depth;
+            int v = -build( &after, ( plies > 1 ) ? plies - 1 : 0, &after_depth );
+            if( v > entry.score )
+            {
+                entry.score = v;
+                entry.move = moves[ i ];
+                entry.depth = after_depth + 1;
+            }
+        }
+
+        if( plies > 0 && count > 0 )
+        {
+            entry.key = key;
+            transform_move( &entry.move, symmetry );
+            add_entry( &entry );
+        }
+
+        *depth = entry.depth;
+        return entry.score;
+    }
+
+    *depth = 0;
+    if( !has_moves( state ) )
+        return LOST_SCORE;
+
+    search_position( state, &entry );
+    *depth = entry.depth;
+    if( plies == 0 )
+        return entry.score;
+
+    entry.key = key;
+    transform_move( &entry.move, symmetry );
+    add_entry( &entry );
+    printf( "%6d positions, %2d pieces: score %6d, depth %2d\n", book_count,
+            popcount( bb_or( state->black, state->white ) ), entry.score, entry.depth );
+    fflush( stdout );
+
+    if( plies > 1 )
+    {
+        struct MoveList moves;
+        int after_depth;
+        actions( state, &moves );
+        for( int i = 0; i < moves.count; i++ )
+        {
+            struct State after = *state;
+            make_move( &after, &moves.moves[ i ] );
+            build( &after, plies - 1, &after_depth );
+        }
+    }
+
+    return entry.score;
+}
+
+/**
+ * Order entries by key
+ *
+ * @param a an entry
+ * @param b an entry
+ * @return negative, zero or positive as a's key is below, equal to or above b's
+ */
+static int compare_entries( const void * a, const void * b )
+{
+    uint64_t x = ( (const struct BookEntry *) a )->key;
+    uint64_t y = ( (const struct BookEntry *) b )->key;
+
+    return ( x > y ) - ( x < y );
+}
+
+int main( int argc, char * argv[] )
+{
+    if( argc < 5 || argc > 6 )
+    {
+        printf( "%s usage: <input file> <output file> <plies> <seconds> [threads]\n", argv[ 0 ] );
+        printf( "   input file - a text file consisting of a konane board\n" );
+        printf( "   output file - the book to write\n" );
+        printf( "   plies - the plies of the game to cover, the removals included\n" );
+        printf( "   seconds - the time to search each position for\n" );
+        printf( "   threads - threads searching each position (default 1)\n" );
+        return EXIT_FAILURE;
+    }
+
+    char board[ SIZE ][ SIZE ];
+    int plies = atoi( argv[ 3 ] );
+    double seconds = atof( argv[ 4 ] );
+
+    if( plies < 1 || seconds <= 0 )
+    {
+        printf( "plies and seconds must be positive\n" );
+        return EXIT_FAILURE;
+    }
+
+    setup_board( argv[ 1 ], board );
+    struct State * state = new_state( board, 'B' );
+
+    arena = new_arena( ARENA_CHUNK_SIZE );
+    set_move_time( seconds * 1000 );
+    set_search_threads( ( argc == 6 ) ? atoi( argv[ 5 ] ) : 1 );
+
+    millis start = clock_ms();
+    int depth;
+    build( state, plies, &depth );
+    qsort( book, book_count, sizeof( struct BookEntry ), compare_entries );
+
+    struct BookHeader header;
+    memset( &header, 0, sizeof( header ) );
+    memcpy( header.magic, BOOK_MAGIC, sizeof( header.magic ) );
+    header.count = book_count;
+    header.plies = plies;
+    header.size = SIZE;
+
+    FILE * file = fopen( argv[ 2 ], "wb" );
+    if( file == NULL ||
+        fwrite( &header, sizeof( header ), 1, file ) != 1 ||
+        fwrite( book, sizeof( struct BookEntry ), book_count, file ) != (size_t) book_count ||
+        fclose( file ) != 0 )
+    {
+        printf( "could not write %s\n", argv[ 2 ] );
+        return EXIT_FAILURE;
+    }
+
+    printf( "Positions: %d\n", book_count );
+    printf( "Size: %zu bytes\n", sizeof( header ) + book_count * sizeof( struct BookEntry ) );
+    printf( "Time: %.3f s\n", ( clock_ms() - start ) / 1000.0 );
+
+    Free( book );
+    delete_arena( &arena );
+    Free( state );
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,26 @@
+/**
+ * @file clock.c
+ * @author Eric Watkins, Julian Martinez del Campo, Michael Hnatiw
+ *
+ * This file provides an implementation of clock.h
+ */
+#define _POSIX_C_SOURCE 200809L
+
+#include <time.h>
+
+#include "clock.h"
+
+/**
+ * Read the monotonic clock
+ *
+ * The clock is not affected by changes to the time of day, so only the
+ * difference between two readings is meaningful.
+ *
+ * @return the current time, in milliseconds
+ */
+millis clock_ms( void )
+{
+    struct timespec ts;
+    clock_gettime( CLOCK_MONOTONIC, &ts );
+    return (millis) ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+}
@@ -0,0 +1,15 @@
+/**
+ * @file clock.h
+ * @author Eric Watkins, Julian Martinez del Campo, Michael Hnatiw
+ *
+ * This file provides a monotonic clock with millisecond resolution
+ */
+#ifndef _CLOCK_H_
+#define _CLOCK_H_
+
+/** a point in time or a duration, in milliseconds */
+typedef long long millis;
+
+millis clock_ms( void );
+
+#endif /* _CLOCK_H_ */
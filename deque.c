@@ -0,0 +1,150 @@
+/**
+ * @file deque.c
+ * @author Eric Watkins, Julian Martinez del Campo, Michael Hnatiw
+ *
+ * This file provides an implementation of deque.h
+ */
+#include <stdlib.h>
+#include <assert.h>
+
+#include "deque.h"
+#include "konane.h"
+#include "utility.h"
+
+/**
+ * Check if a task belongs below a split point
+ *
+ * @param task a task
+ * @param within a split point, or null for any
+ * @return 1 if within is the task's split point or one of its ancestors,
+ *  else return 0
+ */
+static int task_within( const struct Task * task, const struct SplitPoint * within )
+{
+    if( within == NULL )
+        return 1;
+
+    for( const struct SplitPoint * split = task->split; split != NULL; split = split->parent )
+        if( split == within )
+            return 1;
+
+    return 0;
+}
+
+/**
+ * Create a new deque
+ *
+ * @param capacity the most tasks the deque holds
+ * @return a new empty deque, or null if it does not fit in the memory
+ * limit
+ */
+struct Deque * new_deque( int capacity )
+{
+    struct Deque * deque = Calloc( 1, sizeof( struct Deque ) );
+    if( deque == NULL )
+        return NULL;
+
+    deque->tasks = Calloc( capacity, sizeof( struct Task ) );
+    if( deque->tasks == NULL )
+    {
+        Free( deque );
+        return NULL;
+    }
+
+    deque->capacity = capacity;
+    pthread_mutex_init( &deque->lock, NULL );
+
+    return deque;
+}
+
+/**
+ * Delete a deque
+ *
+ * @param deque a deque to destroy, may point to null
+ */
+void delete_deque( struct Deque ** deque )
+{
+    if( *deque == NULL )
+        return;
+
+    pthread_mutex_destroy( &(*deque)->lock );
+    Free( (*deque)->tasks );
+    Free( *deque );
+    *deque = NULL;
+}
+
+/**
+ * Push a task on the bottom of a deque
+ *
+ * @param deque the deque of the current thread
+ * @param task a task to add
+ */
+void push_deque( struct Deque * deque, const struct Task * task )
+{
+    pthread_mutex_lock( &deque->lock );
+
+    assert( deque->count < deque->capacity );
+    deque->tasks[ ( deque->top + deque->count ) % deque->capacity ] = *task;
+    deque->count++;
+
+    pthread_mutex_unlock( &deque->lock );
+}
+
+/**
+ * Pop the newest task from the bottom of a deque
+ *
+ * @param deque the deque of the current thread
+ * @param task set to the task taken
+ * @param within only take a task below this split point, or null for any
+ * @return 1 if a task was taken, else return 0
+ */
+int pop_deque( struct Deque * deque, struct Task * task, const struct SplitPoint * within )
+{
+    int found = 0;
+
+    pthread_mutex_lock( &deque->lock );
+
+    if( deque->count > 0 )
+    {
+        const struct Task * bottom =
+            &deque->tasks[ ( deque->top + deque->count - 1 ) % deque->capacity ];
+
+        if( task_within( bottom, within ) )
+        {
+            *task = *bottom;
+            deque->count--;
+            found = 1;
+        }
+    }
+
+    pthread_mutex_unlock( &deque->lock );
+
+    return found;
+}
+
+/**
+ * Steal the oldest task from the top of another thread's deque
+ *
+ * @param deque a deque of another thread
+ * @param task set to the task taken
+ * @param within only take a task below this split point, or null for any
+ * @return 1 if a task was taken, else return 0
+ */
+int steal_deque( struct Deque * deque, struct Task * task, const struct SplitPoint * within )
+{
+    int found = 0;
+
+    pthread_mutex_lock( &deque->lock );
+
+    if( deque->count > 0 && task_within( &deque->tasks[ deque->top ], within ) )
+    {
+        *task = deque->tasks[ deque->top ];
+        deque->top = ( deque->top + 1 ) % deque->capacity;
+        deque->count--;
+        found = 1;
+    }
+
+    pthread_mutex_unlock( &deque->lock );
+
+    return found;
+}
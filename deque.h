@@ -0,0 +1,40 @@
+/**
+ * @file deque.h
+ * @author Eric Watkins, Julian Martinez del Campo, Michael Hnatiw
+ *
+ * This file provides the task deques of the split search. A thread pushes
+ * and pops tasks at the bottom of its own deque, and other threads steal
+ * from the top.
+ */
+#ifndef _DEQUE_H_
+#define _DEQUE_H_
+
+#include <pthread.h>
+
+#include "move.h"
+
+struct SplitPoint;
+
+/** a move of a split point waiting to be searched */
+struct Task {
+    struct SplitPoint * split;  /**< the node the move is made from */
+    struct Move move;           /**< the move to search */
+};
+
+/** a double ended queue of tasks */
+struct Deque {
+    pthread_mutex_t lock;       /**< guards the tasks */
+    struct Task * tasks;        /**< ring buffer of tasks */
+    int capacity;               /**< size of tasks */
+    int top;                    /**< index of the oldest task */
+    int count;                  /**< number of tasks */
+};
+
+struct Deque * new_deque( int capacity );
+void delete_deque( struct Deque ** deque );
+
+void push_deque( struct Deque * deque, const struct Task * task );
+int pop_deque( struct Deque * deque, struct Task * task, const struct SplitPoint * within );
+int steal_deque( struct Deque * deque, struct Task * task, const struct SplitPoint * within );
+
+#endif /* _DEQUE_H_ */
@@ -0,0 +1,27 @@
+/**
+ * @file dispatch.c
+ * @author Eric Watkins, Julian Martinez del Campo, Michael Hnatiw
+ *
+ * The entry point of perft, bench, tbgen, bookgen and selfplay: run the
+ * program's build for the size of the board file among the arguments.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "sizes.h"
+
+#define DECLARE( n ) int size##n##_main( int argc, char * argv[] );
+BOARD_SIZES( DECLARE )
+
+#define RUN( n ) if( size == n ) return size##n##_main( argc, argv );
+#define NAME( n ) " " #n "x" #n
+
+int main( int argc, char * argv[] )
+{
+    int size = find_board_size( argc, argv );
+
+    BOARD_SIZES( RUN )
+
+    printf( "%s: no build for %dx%d boards, only for" BOARD_SIZES( NAME ) "\n", argv[ 0 ], size, size );
+    return EXIT_FAILURE;
+}
@@ -0,0 +1,839 @@
+/**
+ * @file endgame.c
+ * @author Eric Watkins, Julian Martinez del Campo, Michael Hnatiw
+ *
+ * This file provides an implementation of endgame.h
+ *
+ * Konane is a normal play game: the player who cannot move loses. So a
+ * position of independent regions is a sum of games, and its outcome
+ * follows from the canonical forms of the regions (see Berlekamp, Conway
+ * and Guy, Winning Ways). Games are kept in canonical form, each stored
+ * once, so two games are equal exactly when their numbers are.
+ *
+ * The solver keeps every game, comparison, sum and region it has worked
+ * out, from one call to the next, until its tables fill up.
+ */
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include <pthread.h>
+
+#include "endgame.h"
+#include "konane.h"
+#include "move.h"
+#include "arena.h"
+#include "tablebase.h"
+#include "utility.h"
+
+#define ENDGAME_PIECES 18       /* most pieces on the board worth splitting into regions */
+#define REGION_PIECES 16        /* most pieces in a region the solver takes on */
+#define MAX_GAMES ( 1 << 17 )   /* most games the solver holds */
+#define MEMO_SIZE ( 1 << 18 )   /* entries of each memo table, a power of two */
+#define MAX_OPTIONS 256         /* most options of one player in a game */
+#define SOLVE_BUDGET 5000       /* most new games one call may make */
+
+/** the zero game, in which neither player can move */
+#define ZERO 0
+
+/** the value remembered for a region too big to solve, never a game number */
+#define UNSOLVED MAX_GAMES
+
+/** a short game, stored in canonical form unless it is being simplified */
+struct Game {
+    int * options;      /**< numbers of the left options, then the right */
+    int left;           /**< number of left options */
+    int right;          /**< number of right options */
+    uint64_t hash;      /**< hash of the options */
+};
+
+/** a remembered result */
+struct Memo {
+    bitboard key;       /**< what the result is of */
+    bitboard extra;     /**< more of the key, if it needs two words */
+    int value;          /**< the result, or -1 if the entry is empty */
+};
+
+/** a table of remembered results */
+struct MemoTable {
+    struct Memo * entries;  /**< MEMO_SIZE entries */
+    int count;              /**< entries in use */
+};
+
+/** every game made so far, by number */
+static struct Game * games = NULL;
+static int game_count = 0;
+
+/** the number of each game, by the hash of its options, or -1 */
+static int * game_index = NULL;
+
+/** the option lists of the games */
+static struct Arena * option_arena = NULL;
+
+/** results of less_equal(), add_games() and region_value() */
+static struct MemoTable compare_memo;
+static struct MemoTable sum_memo;
+static struct MemoTable region_memo;
+
+/** new games the running call may still make */
+static int budget;
+
+/** one thread solves at a time, the others search on */
+static pthread_mutex_t solver_lock = PTHREAD_MUTEX_INITIALIZER;
+
+static int position_value( const struct State * state );
+
+/**
+ * Mix the bits of a key
+ *
+ * @param x a key
+ * @return a hash of the key
+ */
+static uint64_t mix( uint64_t x )
+{
+    x ^= x >> 33;
+    x *= 0xff51afd7ed558ccdULL;
+    x ^= x >> 33;
+    x *= 0xc4ceb9fe1a85ec53ULL;
+    x ^= x >> 33;
+    return x;
+}
+
+/**
+ * Fold a key into one word
+ *
+ * @param x a key
+ * @return the key's bits, folded into 64
+ */
+static uint64_t fold( bitboard x )
+{
+    uint64_t folded = 0;
+
+    for( int square = 0; square < SIZE * SIZE; square += 64 )
+        folded ^= bb_bits( x, square, 64 );
+
+    return folded;
+}
+
+/**
+ * Find the entry of a key in a memo table
+ *
+ * @param table a table
+ * @param key the key
+ * @param extra more of the key
+ * @return the key's entry, or the empty entry it would go in
+ */
+static struct Memo * find_memo( struct MemoTable * table, bitboard key, bitboard extra )
+{
+    size_t i = mix( fold( key ) ^ mix( fold( extra ) ) ) & ( MEMO_SIZE - 1 );
+
+    while( table->entries[ i ].value != -1 &&
+           !( bb_equal( table->entries[ i ].key, key ) && bb_equal( table->entries[ i ].extra, extra ) ) )
+        i = ( i + 1 ) & ( MEMO_SIZE - 1 );
+
+    return &table->entries[ i ];
+}
+
+/**
+ * Remember a result
+ *
+ * @param table a table
+ * @param key what the result is of
+ * @param extra more of the key
+ * @param value the result, at least 0
+ * @return value, or -1 if the table is full
+ */
+static int store_memo( struct MemoTable * table, bitboard key, bitboard extra, int value )
+{
+    struct Memo * memo = find_memo( table, key, extra );
+
+    if( memo->value == -1 )
+    {
+        /* keep the table sparse enough to probe quickly */
+        if( table->count >= MEMO_SIZE / 4 * 3 )
+            return -1;
+        table->count++;
+    }
+
+    memo->key = key;
+    memo->extra = extra;
+    memo->value = value;
+
+    return value;
+}
+
+/**
+ * Sort a list of games by number and drop repeats
+ *
+ * @param list a list of game numbers
+ * @param count the length of the list
+ * @return the new length of the list
+ */
+static int sort_unique( int list[], int count )
+{
+    int unique = 0;
+
+    for( int i = 1; i < count; i++ )
+    {
+        int value = list[ i ];
+        int j = i - 1;
+
+        while( j >= 0 && list[ j ] > value )
+        {
+            list[ j + 1 ] = list[ j ];
+            j--;
+        }
+        list[ j + 1 ] = value;
+    }
+
+    for( int i = 0; i < count; i++ )
+        if( unique == 0 || list[ unique - 1 ] != list[ i ] )
+            list[ unique++ ] = list[ i ];
+
+    return unique;
+}
+
+/**
+ * Find or make the game with the given options
+ *
+ * @param left the left options, sorted and repeats dropped
+ * @param left_count the number of left options
+ * @param right the right options, sorted and repeats dropped
+ * @param right_count the number of right options
+ * @return the game's number, or -1 if the solver is out of room
+ */
+static int make_game( int left[], int left_count, int right[], int right_count )
+{
+    uint64_t hash = mix( left_count + ( (uint64_t) right_count << 32 ) );
+
+    for( int i = 0; i < left_count; i++ )
+        hash = mix( hash ^ left[ i ] );
+    for( int i = 0; i < right_count; i++ )
+        hash = mix( hash ^ ( (uint64_t) right[ i ] << 32 ) );
+
+    size_t slot = hash & ( MEMO_SIZE - 1 );
+    for( ; game_index[ slot ] != -1; slot = ( slot + 1 ) & ( MEMO_SIZE - 1 ) )
+    {
+        struct Game * game = &games[ game_index[ slot ] ];
+
+        if( game->hash == hash && game->left == left_count && game->right == right_count &&
+            memcmp( game->options, left, left_count * sizeof( int ) ) == 0 &&
+            memcmp( game->options + left_count, right, right_count * sizeof( int ) ) == 0 )
+            return game_index[ slot ];
+    }
+
+    if( game_count >= MAX_GAMES || budget <= 0 )
+        return -1;
+    budget--;
+
+    struct Game * game = &games[ game_count ];
+    game->left = left_count;
+    game->right = right_count;
+    game->hash = hash;
+    game->options = arena_alloc( option_arena, ( left_count + right_count + 1 ) * sizeof( int ) );
+    if( game->options == NULL )
+        return -1;
+
+    memcpy( game->options, left, left_count * sizeof( int ) );
+    memcpy( game->options + left_count, right, right_count * sizeof( int ) );
+
+    game_index[ slot ] = game_count;
+    return game_count++;
+}
+
+/**
+ * Compare two games
+ *
+ * G <= H unless a left option of G is at least H, or a right option of H
+ * is at most G.
+ *
+ * @param g a game number
+ * @param h a game number
+ * @return 1 if g <= h, 0 if not, or -1 if the solver is out of room
+ */
+static int less_equal( int g, int h )
+{
+    uint64_t key = ( (uint64_t) g << 32 ) | (uint64_t) h;
+
+    if( g == h )
+        return 1;
+
+    struct Memo * memo = find_memo( &compare_memo, bb_word( key ), BB_EMPTY );
+    if( memo->value != -1 )
+        return memo->value;
+
+    const struct Game * a = &games[ g ];
+    const struct Game * b = &games[ h ];
+    int result = 1;
+
+    for( int i = 0; i < a->left && result == 1; i++ )
+    {
+        int r = less_equal( h, a->options[ i ] );
+        if( r < 0 )
+            return -1;
+        if( r )
+            result = 0;
+    }
+
+    for( int i = 0; i < b->right && result == 1; i++ )
+    {
+        int r = less_equal( b->options[ b->left + i ], g );
+        if( r < 0 )
+            return -1;
+        if( r )
+            result = 0;
+    }
+
+    return store_memo( &compare_memo, bb_word( key ), BB_EMPTY, result );
+}
+
+/**
+ * Remove the options a player would never choose
+ *
+ * Left never plays an option at most another of his options, and Right
+ * never one at least another of hers.
+ *
+ * @param list options of one player, in canonical form, without repeats
+ * @param count the number of options
+ * @param left 1 if the options are Left's, 0 if Right's
+ * @return the number of options kept, or -1 if the solver is out of room
+ */
+static int remove_dominated( int list[], int count, int left )
+{
+    int dominated[ MAX_OPTIONS ];
+    int kept = 0;
+
+    /* distinct canonical games are never equal, so no two options dominate
+     * each other */
+    for( int i = 0; i < count; i++ )
+    {
+        dominated[ i ] = 0;
+
+        for( int j = 0; j < count && !dominated[ i ]; j++ )
+        {
+            if( i == j )
+                continue;
+
+            dominated[ i ] = left ? less_equal( list[ i ], list[ j ] )
+                                  : less_equal( list[ j ], list[ i ] );
+            if( dominated[ i ] < 0 )
+                return -1;
+        }
+    }
+
+    for( int i = 0; i < count; i++ )
+        if( !dominated[ i ] )
+            list[ kept++ ] = list[ i ];
+
+    return kept;
+}
+
+/**
+ * Find the canonical form of a game
+ *
+ * Dominated options are removed and reversible options bypassed, until
+ * neither is left.
+ *
+ * @param left the left options, in canonical form
+ * @param left_count the number of left options
+ * @param right the right options, in canonical form
+ * @param right_count the number of right options
+ * @return the canonical game's number, or -1 if the solver is out of room
+ */
+static int canonical_game( const int left[], int left_count, const int right[], int right_count )
+{
+    int l[ MAX_OPTIONS ];
+    int r[ MAX_OPTIONS ];
+    int changed = 1;
+
+    if( left_count > MAX_OPTIONS || right_count > MAX_OPTIONS )
+        return -1;
+
+    memcpy( l, left, left_count * sizeof( int ) );
+    memcpy( r, right, right_count * sizeof( int ) );
+
+    while( changed )
+    {
+        changed = 0;
+
+        left_count = remove_dominated( l, sort_unique( l, left_count ), 1 );
+        right_count = remove_dominated( r, sort_unique( r, right_count ), 0 );
+        if( left_count < 0 || right_count < 0 )
+            return -1;
+
+        int g = make_game( l, left_count, r, right_count );
+        if( g < 0 )
+            return -1;
+
+        /* a left option G^L is reversible through G^LR <= G, and is
+         * replaced by the left options of G^LR */
+        for( int i = 0; i < left_count && !changed; i++ )
+        {
+            const struct Game * option = &games[ l[ i ] ];
+
+            for( int j = 0; j < option->right && !changed; j++ )
+            {
+                const struct Game * reverse = &games[ option->options[ option->left + j ] ];
+                int reversible = less_equal( option->options[ option->left + j ], g );
+
+                if( reversible < 0 )
+                    return -1;
+                if( !reversible )
+                    continue;
+                if( left_count - 1 + reverse->left > MAX_OPTIONS )
+                    return -1;
+
+                l[ i ] = l[ --left_count ];
+                memcpy( &l[ left_count ], reverse->options, reverse->left * sizeof( int ) );
+                left_count += reverse->left;
+                changed = 1;
+            }
+        }
+
+        /* a right option G^R is reversible through G^RL >= G, and is
+         * replaced by the right options of G^RL */
+        for( int i = 0; i < right_count && !changed; i++ )
+        {
+            const struct Game * option = &games[ r[ i ] ];
+
+            for( int j = 0; j < option->left && !changed; j++ )
+            {
+                const struct Game * reverse = &games[ option->options[ j ] ];
+                int reversible = less_equal( g, option->options[ j ] );
+
+                if( reversible < 0 )
+                    return -1;
+                if( !reversible )
+                    continue;
+                if( right_count - 1 + reverse->right > MAX_OPTIONS )
+                    return -1;
+
+                r[ i ] = r[ --right_count ];
+                memcpy( &r[ right_count ], reverse->options + reverse->left,
+                        reverse->right * sizeof( int ) );
+                right_count += reverse->right;
+                changed = 1;
+            }
+        }
+    }
+
+    return make_game( l, left_count, r, right_count );
+}
+
+/**
+ * Add two games
+ *
+ * In G + H a player moves in either G or H.
+ *
+ * @param g a game number
+ * @param h a game number
+ * @return the number of the sum, or -1 if the solver is out of room
+ */
+static int add_games( int g, int h )
+{
+    if( g == ZERO )
+        return h;
+    if( h == ZERO )
+        return g;
+
+    /* addition commutes, so remember each pair once */
+    if( g > h )
+    {
+        int t = g;
+        g = h;
+        h = t;
+    }
+
+    uint64_t key = ( (uint64_t) g << 32 ) | (uint64_t) h;
+    struct Memo * memo = find_memo( &sum_memo, bb_word( key ), BB_EMPTY );
+    if( memo->value != -1 )
+        return memo->value;
+
+    const struct Game * a = &games[ g ];
+    const struct Game * b = &games[ h ];
+    int left[ MAX_OPTIONS ];
+    int right[ MAX_OPTIONS ];
+    int left_count = 0;
+    int right_count = 0;
+
+    if( a->left + b->left > MAX_OPTIONS || a->right + b->right > MAX_OPTIONS )
+        return -1;
+
+    for( int i = 0; i < a->left; i++ )
+        if( ( left[ left_count++ ] = add_games( a->options[ i ], h ) ) < 0 )
+            return -1;
+    for( int i = 0; i < b->left; i++ )
+        if( ( left[ left_count++ ] = add_games( g, b->options[ i ] ) ) < 0 )
+            return -1;
+    for( int i = 0; i < a->right; i++ )
+        if( ( right[ right_count++ ] = add_games( a->options[ a->left + i ], h ) ) < 0 )
+            return -1;
+    for( int i = 0; i < b->right; i++ )
+        if( ( right[ right_count++ ] = add_games( g, b->options[ b->left + i ] ) ) < 0 )
+            return -1;
+
+    int sum = canonical_game( left, left_count, right, right_count );
+    if( sum < 0 )
+        return -1;
+
+    return store_memo( &sum_memo, bb_word( key ), BB_EMPTY, sum );
+}
+
+/**
+ * Grow a set of squares by one step in every direction
+ *
+ * @param b a mask
+ * @return b and every square next to it
+ */
+static bitboard dilate( bitboard b )
+{
+    return bb_or( bb_or( b, bb_or( shift( b, RIGHT ), shift( b, LEFT ) ) ),
+                  bb_or( shift( b, DOWN ), shift( b, UP ) ) );
+}
+
+/**
+ * Find every square a group of pieces could ever occupy, if it only plays
+ * among itself
+ *
+ * Every capture lands next to the piece captured, so after k captures the
+ * pieces are at most k steps from where the group started, and a group of
+ * n pieces makes at most n - 1 captures. Within that bound, the squares
+ * are closed under jumping, ignoring that jumped pieces are removed and
+ * landing squares must be empty.
+ *
+ * @param black the group's black pieces
+ * @param white the group's white pieces
+ * @return a superset of the squares the group's pieces can reach
+ */
+static bitboard reach( bitboard black, bitboard white )
+{
+    bitboard bound = bb_or( black, white );
+    bitboard last_black, last_white;
+
+    for( int i = popcount( bb_or( black, white ) ); i > 1; i-- )
+        bound = dilate( bound );
+
+    do
+    {
+        last_black = black;
+        last_white = white;
+
+        for( int direction = 0; direction < DIRECTIONS; direction++ )
+        {
+            black = bb_or( black, jumps( black, white, bound, direction ) );
+            white = bb_or( white, jumps( white, black, bound, direction ) );
+        }
+    } while( !bb_equal( black, last_black ) || !bb_equal( white, last_white ) );
+
+    return bb_or( black, white );
+}
+
+/**
+ * Split a position into regions that can never interact
+ *
+ * Groups of touching pieces are merged while the squares one group could
+ * reach touch the squares another could. What is left are regions whose
+ * pieces can never jump each other or land on each other's squares.
+ *
+ * @param state a state
+ * @param regions set to the pieces of each region, SIZE * SIZE long
+ * @param reaches set to the squares each region could reach, SIZE * SIZE long
+ * @return the number of regions
+ */
+static int find_regions( const struct State * state, bitboard regions[], bitboard reaches[] )
+{
+    bitboard pieces = bb_or( state->black, state->white );
+    int count = 0;
+
+    /* start from groups of touching pieces */
+    for( bitboard left = pieces; !bb_none( left ); )
+    {
+        bitboard rest = left;
+        bitboard group = bb_square( pop_square( &rest ) );
+        bitboard last;
+
+        do
+        {
+            last = group;
+            group = bb_and( dilate( group ), pieces );
+        } while( !bb_equal( group, last ) );
+
+        reaches[ count ] = reach( bb_and( state->black, group ), bb_and( state->white, group ) );
+        regions[ count++ ] = group;
+        left = bb_andnot( left, group );
+    }
+
+    /* merge groups that could meet, until none can */
+    for( int i = 0; i < count; i++ )
+        for( int j = i + 1; j < count; j++ )
+            if( !bb_none( bb_and( dilate( reaches[ i ] ), reaches[ j ] ) ) )
+            {
+                regions[ i ] = bb_or( regions[ i ], regions[ j ] );
+                regions[ j ] = regions[ --count ];
+                reaches[ j ] = reaches[ count ];
+                reaches[ i ] = reach( bb_and( state->black, regions[ i ] ), bb_and( state->white, regions[ i ] ) );
+
+                /* the grown region may now meet any other, check them all again */
+                i = -1;
+                break;
+            }
+
+    return count;
+}
+
+/**
+ * Work out the value of a region from its options
+ *
+ * @param black the region's black pieces
+ * @param white the region's white pieces
+ * @return the number of the region's canonical form, or -1 if the solver
+ *  is out of room
+ */
+static int solve_region( bitboard black, bitboard white )
+{
+    struct State state = { 0 };
+    struct MoveList moves;
+    int options[ 2 ][ MAX_OPTIONS ];
+    int counts[ 2 ] = { 0, 0 };
+
+    state.black = black;
+    state.white = white;
+
+    /* black is Left, white is Right */
+    for( int side = 0; side < 2; side++ )
+    {
+        state.player = side ? 'W' : 'B';
+        actions( &state, &moves );
+        if( moves.count > MAX_OPTIONS )
+            return -1;
+
+        for( int i = 0; i < moves.count; i++ )
+        {
+            struct State after = state;
+            make_move( &after, &moves.moves[ i ] );
+
+            if( ( options[ side ][ counts[ side ]++ ] = position_value( &after ) ) < 0 )
+                return -1;
+        }
+    }
+
+    return canonical_game( options[ 0 ], counts[ 0 ], options[ 1 ], counts[ 1 ] );
+}
+
+
+/**
+ * Find the value of a region
+ *
+ * @param black the region's black pieces
+ * @param white the region's white pieces
+ * @return the number of the region's canonical form, or -1 if the region
+ *  is too big to solve or the solver is out of room
+ */
+static int region_value( bitboard black, bitboard white )
+{
+    struct Memo * memo = find_memo( &region_memo, black, white );
+    if( memo->value == UNSOLVED )
+        return -1;
+    if( memo->value != -1 )
+        return memo->value;
+
+    int value = solve_region( black, white );
+
+    /* a region that used up a call's budget would only use up the next */
+    if( value < 0 )
+    {
+        if( budget <= 0 )
+            store_memo( &region_memo, black, white, UNSOLVED );
+        return -1;
+    }
+
+    return store_memo( &region_memo, black, white, value );
+}
+
+/**
+ * Find the value of a position, as the sum of its regions
+ *
+ * @param state a state
+ * @return the number of the position's canonical form, or -1 if a region
+ *  is too big or the solver is out of room
+ */
+static int position_value( const struct State * state )
+{
+    bitboard regions[ SIZE * SIZE ];
+    bitboard reaches[ SIZE * SIZE ];
+    int count = find_regions( state, regions, reaches );
+    int value = ZERO;
+
+    for( int i = 0; i < count && value >= 0; i++ )
+    {
+        bitboard black = bb_and( state->black, regions[ i ] );
+        bitboard white = bb_and( state->white, regions[ i ] );
+
+        /* every move jumps the other colour, so one colour alone is zero */
+        if( bb_none( black ) || bb_none( white ) )
+            continue;
+
+        if( popcount( regions[ i ] ) > REGION_PIECES )
+            return -1;
+
+        int region = region_value( black, white );
+        if( region < 0 )
+            return -1;
+
+        value = add_games( value, region );
+    }
+
+    return value;
+}
+
+/**
+ * Forget every game, and start again from zero
+ *
+ * @return 1 if the solver's tables are ready, or 0 if they do not fit in
+ * the memory limit
+ */
+static int reset_solver( void )
+{
+    if( games == NULL )
+    {
+        games = Calloc( MAX_GAMES, sizeof( struct Game ) );
+        game_index = Calloc( MEMO_SIZE, sizeof( int ) );
+        compare_memo.entries = Calloc( MEMO_SIZE, sizeof( struct Memo ) );
+        sum_memo.entries = Calloc( MEMO_SIZE, sizeof( struct Memo ) );
+        region_memo.entries = Calloc( MEMO_SIZE, sizeof( struct Memo ) );
+
+        /* without the tables, positions are left to the search */
+        if( games == NULL || game_index == NULL || compare_memo.entries == NULL ||
+            sum_memo.entries == NULL || region_memo.entries == NULL )
+        {
+            Free( games );
+            Free( game_index );
+            Free( compare_memo.entries );
+            Free( sum_memo.entries );
+            Free( region_memo.entries );
+            games = NULL;
+            game_index = NULL;
+            compare_memo.entries = sum_memo.entries = region_memo.entries = NULL;
+            return 0;
+        }
+
+        option_arena = new_arena( ARENA_CHUNK_SIZE );
+        assert( option_arena );
+    }
+
+    /* all bits set is -1, the empty value */
+    memset( game_index, 0xFF, MEMO_SIZE * sizeof( int ) );
+    memset( compare_memo.entries, 0xFF, MEMO_SIZE * sizeof( struct Memo ) );
+    memset( sum_memo.entries, 0xFF, MEMO_SIZE * sizeof( struct Memo ) );
+    memset( region_memo.entries, 0xFF, MEMO_SIZE * sizeof( struct Memo ) );
+    compare_memo.count = sum_memo.count = region_memo.count = 0;
+    reset_arena( option_arena );
+    game_count = 0;
+
+    int none[ 1 ];
+    budget = 1;
+    make_game( none, 0, none, 0 );
+
+    return 1;
+}
+
+/**
+ * Forget every game and position the solver has worked out
+ */
+void clear_endgame( void )
+{
+    pthread_mutex_lock( &solver_lock );
+    if( games != NULL )
+        reset_solver();
+    pthread_mutex_unlock( &solver_lock );
+}
+
+/**
+ * Look a position up in the tablebase
+ *
+ * A region with pieces of one colour only is dead, none of its pieces can
+ * ever move. If only one region is alive, the position's outcome is that
+ * region's.
+ *
+ * @param state a state
+ * @return OUTCOME_WIN or OUTCOME_LOSS for the player to move, or
+ *  OUTCOME_UNKNOWN if the position is not in the tablebase
+ */
+int probe_endgame( const struct State * state )
+{
+    bitboard regions[ SIZE * SIZE ];
+    bitboard reaches[ SIZE * SIZE ];
+    int alive = -1;
+
+    if( !has_tablebase() || popcount( bb_or( state->black, state->white ) ) > ENDGAME_PIECES )
+        return OUTCOME_UNKNOWN;
+
+    int count = find_regions( state, regions, reaches );
+    for( int i = 0; i < count; i++ )
+        if( !bb_none( bb_and( state->black, regions[ i ] ) ) && !bb_none( bb_and( state->white, regions[ i ] ) ) )
+        {
+            if( alive >= 0 )
+                return OUTCOME_UNKNOWN;
+            alive = i;
+        }
+
+    /* neither player can ever move again */
+    if( alive < 0 )
+        return OUTCOME_LOSS;
+
+    return probe_tablebase( bb_and( state->black, regions[ alive ] ), bb_and( state->white, regions[ alive ] ),
+                            reaches[ alive ], state->player );
+}
+
+/**
+ * Solve a position exactly, if it falls into small enough regions
+ *
+ * Only one thread solves at a time; a position is left unsolved if
+ * another thread is solving, so the search never waits on the solver.
+ *
+ * @param state a state
+ * @return OUTCOME_WIN or OUTCOME_LOSS for the player to move, or
+ *  OUTCOME_UNKNOWN if the position was not solved
+ */
+int solve_endgame( const struct State * state )
+{
+    int outcome = OUTCOME_UNKNOWN;
+
+    if( popcount( bb_or( state->black, state->white ) ) > ENDGAME_PIECES )
+        return OUTCOME_UNKNOWN;
+
+    /* a position in the tablebase needs no solving */
+    outcome = probe_endgame( state );
+    if( outcome != OUTCOME_UNKNOWN )
+        return outcome;
+
+    if( pthread_mutex_trylock( &solver_lock ) != 0 )
+        return OUTCOME_UNKNOWN;
+
+    /* start again once the tables are too full to take a new solve */
+    if( games == NULL || game_count > MAX_GAMES - SOLVE_BUDGET ||
+        compare_memo.count > MEMO_SIZE / 2 || sum_memo.count > MEMO_SIZE / 2 ||
+        region_memo.count > MEMO_SIZE / 2 )
+    {
+        if( !reset_solver() )
+        {
+            pthread_mutex_unlock( &solver_lock );
+            return OUTCOME_UNKNOWN;
+        }
+    }
+
+    budget = SOLVE_BUDGET;
+    int value = position_value( state );
+
+    /* Left wins moving first unless G <= 0, Right unless G >= 0 */
+    if( value >= 0 )
+    {
+        int loss = ( state->player == 'B' ) ? less_equal( value, ZERO )
+                                            : less_equal( ZERO, value );
+        if( loss >= 0 )
+            outcome = loss ? OUTCOME_LOSS : OUTCOME_WIN;
+    }
+
+    pthread_mutex_unlock( &solver_lock );
+
+    return outcome;
+}
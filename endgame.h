@@ -0,0 +1,26 @@
+/**
+ * @file endgame.h
+ * @author Eric Watkins, Julian Martinez del Campo, Michael Hnatiw
+ *
+ * This file provides an exact endgame solver. Late in the game the pieces
+ * fall apart into regions that can never interact. Each region is solved
+ * on its own as a combinatorial game, black playing Left and white Right,
+ * and the position is the sum of its regions.
+ */
+#ifndef _ENDGAME_H_
+#define _ENDGAME_H_
+
+#include "state.h"
+
+/** the result of solving a position */
+enum Outcome {
+    OUTCOME_UNKNOWN = 0,    /**< the position is too big to solve */
+    OUTCOME_WIN,            /**< the player to move wins */
+    OUTCOME_LOSS            /**< the player to move loses */
+};
+
+int probe_endgame( const struct State * state );
+int solve_endgame( const struct State * state );
+void clear_endgame( void );
+
+#endif /* _ENDGAME_H_ */
@@ -0,0 +1,543 @@
+/**
+ * @file engine.c
+ * @author Eric Watkins, Julian Martinez del Campo, Michael Hnatiw
+ *
+ * This file provides an implementation of engine.h
+ *
+ * Commands are read by the main thread. A go command starts a search
+ * thread, which writes the info lines and the best move, so that isready,
+ * stop and ponderhit are answered while it searches. The transposition
+ * table, history and search tree arena live as long as the process.
+ */
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdarg.h>
+#include <string.h>
+#include <limits.h>
+#include <pthread.h>
+
+#include "engine.h"
+#include "book.h"
+#include "konane.h"
+#include "state.h"
+#include "move.h"
+#include "game_node.h"
+#include "arena.h"
+#include "clock.h"
+#include "utility.h"
+
+#define LINE_SIZE 4096      /* longest command, and longest line written */
+#define SEPARATORS " \t\r\n"
+
+/** what the last go command asked for */
+struct Go {
+    int infinite;       /**< 1 if bestmove waits for stop */
+    int ponder;         /**< 1 if bestmove waits for stop or ponderhit */
+    int timed;          /**< 1 if movetime or a clock limits the search */
+};
+
+/** the position set by the last position command */
+static struct State position;
+
+/** the search thread, set while it has not been joined */
+static pthread_t searcher;
+static int searching = 0;
+
+/** the go command being searched */
+static struct Go go;
+
+/** stop and ponderhit received for the running search, guarded by lock */
+static pthread_mutex_t lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t changed = PTHREAD_COND_INITIALIZER;
+static int stopped = 0;
+static int ponderhit = 0;
+
+/** 1 while the search ponders, until ponderhit, guarded by lock */
+static int pondering = 0;
+
+/** keeps the lines of the two threads apart */
+static pthread_mutex_t output_lock = PTHREAD_MUTEX_INITIALIZER;
+
+/** when the running search started, for the info lines */
+static millis search_start;
+
+/** arena of the search trees */
+static struct Arena * arena = NULL;
+
+/**
+ * Write a line to stdout
+ *
+ * @param format a printf() format, ending in a newline
+ */
+static void send( const char * format, ... )
+{
+    va_list args;
+
+    pthread_mutex_lock( &output_lock );
+    va_start( args, format );
+    vprintf( format, args );
+    va_end( args );
+    fflush( stdout );
+    pthread_mutex_unlock( &output_lock );
+}
+
+/**
+ * Write an info line for a completed iteration
+ *
+ * @param game_state the searched root
+ */
+static void report( const struct GameNode * game_state )
+{
+    char line[ LINE_SIZE ];
+    char token[ TOKEN_LEN ];
+    millis elapsed = clock_ms() - search_start;
+    unsigned long nps = ( elapsed > 0 ) ? game_state->nodes * 1000 / elapsed : 0;
+    int length = snprintf( line, sizeof( line ), "info depth %d score %d nodes %lu time %lld nps %lu pv",
+                           game_state->depth, game_state->best_util_val, game_state->nodes,
+                           elapsed, nps );
+
+    for( int i = 0; i < game_state->pv_length && length < LINE_SIZE - TOKEN_LEN; i++ )
+    {
+        move2token( &game_state->pv[ i ], token );
+        length += snprintf( line + length, sizeof( line ) - length, " %s", token );
+    }
+
+    send( "%s\n", line );
+}
+
+/**
+ * Wait for stop, or for ponderhit
+ *
+ * @return 1 if the move pondered on was played, 0 to stop
+ */
+static int wait_for_stop( void )
+{
+    int hit;
+
+    pthread_mutex_lock( &lock );
+    while( !stopped && !ponderhit )
+        pthread_cond_wait( &changed, &lock );
+
+    /* let the search after ponderhit run */
+    hit = !stopped;
+    ponderhit = 0;
+    pondering = 0;
+    if( hit )
+        set_search_stop( 0 );
+    pthread_mutex_unlock( &lock );
+
+    return hit;
+}
+
+/**
+ * Choose a removal that opens the game
+ *
+ * @param state a state with at most one empty square
+ * @param move set to the book's removal, or else the first one open
+ * @return 1 if there is a removal, else return 0
+ */
+static int choose_removal( const struct State * state, struct Move * move )
+{
+    struct Move moves[ MAX_REMOVALS ];
+    struct BookEntry entry;
+    int count = removals( state, moves );
+
+    if( count == 0 )
+        return 0;
+
+    *move = moves[ 0 ];
+    if( probe_book( state, &entry ) )
+        for( int i = 0; i < count; i++ )
+            if( compare_move( &moves[ i ], &entry.move ) )
+                *move = entry.move;
+
+    return 1;
+}
+
+/**
+ * Search the position and write the best move
+ *
+ * @param unused unused
+ * @return null
+ */
+static void * search_thread( void * unused )
+{
+    struct State state = position;
+    struct GameNode * root = NULL;
+    struct BookEntry entry;
+    struct Move move;
+    int found = 0;
+    int waited = 0;
+
+    if( popcount( empty_squares( &state ) ) <= 1 && choose_removal( &state, &move ) )
+        found = 1;
+    else if( !go.infinite && probe_book( &state, &entry ) && validate_action( &state, &entry.move ) )
+    {
+        move = entry.move;
+        found = 1;
+    }
+    else if( has_moves( &state ) )
+    {
+        root = new_game_node( arena, &state, NULL );
+        search_start = clock_ms();
+
+        if( go.infinite || go.ponder )
+        {
+            infinite_search( root );
+            waited = 1;
+
+            /* after ponderhit, carry on from the iterations already done */
+            if( wait_for_stop() )
+            {
+                search_start = clock_ms();
+                if( go.timed )
+                    alpha_beta_search( root );
+                else
+                    infinite_search( root );
+            }
+        }
+        else if( go.timed )
+            alpha_beta_search( root );
+        else
+            infinite_search( root );
+
+        if( root->pv_length > 0 )
+        {
+            move = root->pv[ 0 ];
+            found = 1;
+        }
+        else
+        {
+            /* stopped before any move was searched */
+            struct MoveList moves;
+            actions( &state, &moves );
+            move = moves.moves[ 0 ];
+            found = 1;
+        }
+    }
+
+    if( ( go.infinite || go.ponder ) && !waited )
+        wait_for_stop();
+
+    if( !found )
+        send( "bestmove none\n" );
+    else if( root != NULL && root->pv_length > 1 )
+    {
+        char token[ TOKEN_LEN ];
+        char reply[ TOKEN_LEN ];
+
+        move2token( &move, token );
+        move2token( &root->pv[ 1 ], reply );
+        send( "bestmove %s ponder %s\n", token, reply );
+    }
+    else
+    {
+        char token[ TOKEN_LEN ];
+
+        move2token( &move, token );
+        send( "bestmove %s\n", token );
+    }
+
+    if( root != NULL )
+        Free( root->best_move );
+    reset_arena( arena );
+
+    return unused;
+}
+
+/**
+ * Stop the search, if there is one, once it has written its best move
+ */
+static void stop_search( void )
+{
+    if( !searching )
+        return;
+
+    pthread_mutex_lock( &lock );
+    stopped = 1;
+    set_search_stop( 1 );
+    pthread_cond_signal( &changed );
+    pthread_mutex_unlock( &lock );
+
+    pthread_join( searcher, NULL );
+    searching = 0;
+}
+
+/**
+ * Start searching the position
+ *
+ * @param save the rest of the go command, for strtok_r()
+ */
+static void start_search( char ** save )
+{
+    char * word;
+    millis movetime = 0;
+    millis time[ 2 ] = { 0, 0 };
+    millis increment[ 2 ] = { 0, 0 };
+    int depth = 0;
+    unsigned long nodes = 0;
+    int side = ( position.player == 'W' );
+
+    stop_search();
+    memset( &go, 0, sizeof( go ) );
+
+    while( ( word = strtok_r( NULL, SEPARATORS, save ) ) != NULL )
+    {
+        if( strcmp( word, "infinite" ) == 0 )
+            go.infinite = 1;
+        else if( strcmp( word, "ponder" ) == 0 )
+            go.ponder = 1;
+        else
+        {
+            char * value = strtok_r( NULL, SEPARATORS, save );
+            long long number = ( value != NULL ) ? strtoll( value, NULL, 10 ) : 0;
+
+            if( strcmp( word, "movetime" ) == 0 )
+                movetime = number;
+            else if( strcmp( word, "wtime" ) == 0 )
+                time[ 1 ] = number;
+            else if( strcmp( word, "btime" ) == 0 )
+                time[ 0 ] = number;
+            else if( strcmp( word, "winc" ) == 0 )
+                increment[ 1 ] = number;
+            else if( strcmp( word, "binc" ) == 0 )
+                increment[ 0 ] = number;
+            else if( strcmp( word, "depth" ) == 0 )
+                depth = number;
+            else if( strcmp( word, "nodes" ) == 0 )
+                nodes = number;
+            else
+                send( "info string unknown go option %s\n", word );
+        }
+    }
+
+    set_search_depth( ( depth > 0 ) ? depth : INT_MAX );
+    set_search_nodes( nodes );
+
+    if( movetime > 0 )
+    {
+        set_move_time( movetime );
+        go.timed = 1;
+    }
+    else if( time[ side ] > 0 )
+    {
+        set_game_clock( time[ side ], increment[ side ] );
+        go.timed = 1;
+    }
+
+    stopped = 0;
+    ponderhit = 0;
+    pondering = go.ponder;
+    set_search_stop( 0 );
+
+    searching = ( pthread_create( &searcher, NULL, search_thread, NULL ) == 0 );
+    if( !searching )
+        send( "info string could not start the search\n" );
+}
+
+/**
+ * Play a move of the position commands
+ *
+ * @param state a state
+ * @param move a removal while the game opens, else a jump
+ * @return 1 if the move was legal and played, else return 0
+ */
+static int play_move( struct State * state, const struct Move * move )
+{
+    if( popcount( empty_squares( state ) ) <= 1 )
+    {
+        struct Move moves[ MAX_REMOVALS ];
+        int count = removals( state, moves );
+
+        for( int i = 0; i < count; i++ )
+            if( compare_move( &moves[ i ], move ) )
+            {
+                set_piece( state, move->start_row, move->start_col, 'O' );
+                state->player = opposite_player( state->player );
+                return 1;
+            }
+
+        if( count > 0 )
+            return 0;
+    }
+
+    if( !validate_action( state, move ) )
+        return 0;
+
+    make_move( state, move );
+
+    return 1;
+}
+
+/**
+ * Read the board of a position command
+ *
+ * @param rows the rows from the top, separated by '/'
+ * @param board set to the board
+ * @return 1 if the rows make up a board, else return 0
+ */
+static int read_board( const char * rows, char board[ SIZE ][ SIZE ] )
+{
+    for( int row = 0; row < SIZE; row++ )
+    {
+        for( int col = 0; col < SIZE; col++, rows++ )
+        {
+            if( *rows != 'B' && *rows != 'W' && *rows != 'O' )
+                return 0;
+            board[ row ][ col ] = *rows;
+        }
+
+        if( *rows != ( ( row < SIZE - 1 ) ? '/' : '\0' ) )
+            return 0;
+        rows++;
+    }
+
+    return 1;
+}
+
+/**
+ * Set the position to the start of a game, every square filled
+ */
+static void start_position( void )
+{
+    char board[ SIZE ][ SIZE ];
+
+    for( int row = 0; row < SIZE; row++ )
+        for( int col = 0; col < SIZE; col++ )
+            board[ row ][ col ] = ( ( row + col ) % 2 == 0 ) ? 'B' : 'W';
+
+    struct State * state = new_state( board, 'B' );
+    position = *state;
+    Free( state );
+}
+
+/**
+ * Set the position
+ *
+ * @param save the rest of the position command, for strtok_r()
+ */
+static void set_position( char ** save )
+{
+    char * word = strtok_r( NULL, SEPARATORS, save );
+
+    if( word != NULL && strcmp( word, "startpos" ) == 0 )
+        start_position();
+    else if( word != NULL && strcmp( word, "board" ) == 0 )
+    {
+        char board[ SIZE ][ SIZE ];
+        char * rows = strtok_r( NULL, SEPARATORS, save );
+        char * side = strtok_r( NULL, SEPARATORS, save );
+
+        if( rows == NULL || side == NULL || !read_board( rows, board ) ||
+            ( strcmp( side, "B" ) != 0 && strcmp( side, "W" ) != 0 ) )
+        {
+            send( "info string position board needs %d rows of %d squares and B or W\n", SIZE, SIZE );
+            return;
+        }
+
+        struct State * state = new_state( board, side[ 0 ] );
+        position = *state;
+        Free( state );
+    }
+    else
+    {
+        send( "info string position needs startpos or board\n" );
+        return;
+    }
+
+    word = strtok_r( NULL, SEPARATORS, save );
+    if( word == NULL || strcmp( word, "moves" ) != 0 )
+        return;
+
+    while( ( word = strtok_r( NULL, SEPARATORS, save ) ) != NULL )
+    {
+        struct Move move;
+
+        if( !token2move( word, &move ) || !play_move( &position, &move ) )
+        {
+            send( "info string illegal move %s\n", word );
+            break;
+        }
+    }
+}
+
+/**
+ * Make the engine ready for commands, at the start position
+ */
+void engine_open( void )
+{
+    arena = new_arena( ARENA_CHUNK_SIZE );
+    set_search_report( report );
+    start_position();
+}
+
+/**
+ * Answer a command
+ *
+ * @param line the command's line, which strtok_r() takes apart
+ * @return 0 after quit, else return 1
+ */
+int engine_command( char * line )
+{
+    char * save = NULL;
+    char * command = strtok_r( line, SEPARATORS, &save );
+
+    if( command == NULL )
+        return 1;
+
+    if( strcmp( command, "konane" ) == 0 )
+    {
+        send( "id name Konane\n" );
+        send( "id author Eric Watkins, Julian Martinez del Campo, Michael Hnatiw\n" );
+        send( "konaneok\n" );
+    }
+    else if( strcmp( command, "isready" ) == 0 )
+        send( "readyok\n" );
+    else if( strcmp( command, "newgame" ) == 0 )
+    {
+        stop_search();
+        reset_search();
+        start_position();
+    }
+    else if( strcmp( command, "position" ) == 0 )
+    {
+        stop_search();
+        set_position( &save );
+    }
+    else if( strcmp( command, "go" ) == 0 )
+        start_search( &save );
+    else if( strcmp( command, "stop" ) == 0 )
+        stop_search();
+    else if( strcmp( command, "ponderhit" ) == 0 )
+    {
+        pthread_mutex_lock( &lock );
+        if( pondering )
+        {
+            ponderhit = 1;
+            set_search_stop( 1 );
+            pthread_cond_signal( &changed );
+        }
+        pthread_mutex_unlock( &lock );
+    }
+    else if( strcmp( command, "quit" ) == 0 )
+    {
+        stop_search();
+        return 0;
+    }
+    else
+        send( "info string unknown command %s\n", command );
+
+    return 1;
+}
+
+/**
+ * Stop the search and free the engine's memory
+ */
+void engine_close( void )
+{
+    stop_search();
+    set_search_report( NULL );
+    delete_arena( &arena );
+}
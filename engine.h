@@ -0,0 +1,43 @@
+/**
+ * @file engine.h
+ * @author Eric Watkins, Julian Martinez del Campo, Michael Hnatiw
+ *
+ * This file provides the engine protocol: commands read line by line from
+ * stdin and answers written to stdout, in the style of UCI, so that one
+ * long lived process can search any number of positions and games.
+ *
+ *   konane                     answers id lines, then konaneok
+ *   isready                    answers readyok, even while searching
+ *   newgame [<size>]           forgets the earlier games, back to startpos,
+ *                              on a board of size x size if given
+ *   position startpos [moves <move> ...]
+ *   position board <rows> <B|W> [moves <move> ...]
+ *                              sets the position, rows from the top,
+ *                              separated by '/', of B, W and O
+ *   go [movetime <ms>] [wtime <ms>] [btime <ms>] [winc <ms>] [binc <ms>]
+ *      [depth <plies>] [nodes <nodes>] [infinite] [ponder]
+ *                              searches the position, answering info lines
+ *                              and then bestmove <move> [ponder <move>]
+ *   ponderhit                  the move pondered on was played, the search
+ *                              goes on under the go command's limits
+ *   stop                       stops the search, which answers bestmove
+ *   quit                       stops the search and leaves
+ *
+ * A move is written as by move2token(): D5 for a removal, D5-D3 for a jump.
+ * Without movetime or a clock the search runs until stopped or as deep as
+ * the depth and node limits allow. After go infinite or go ponder,
+ * bestmove waits for stop or ponderhit.
+ *
+ * Each board size has an engine of its own, which keeps its tables while
+ * another size is played. main.c reads the lines and passes each one to
+ * the engine of the size set by the last newgame or position board
+ * command, 8x8 to begin with.
+ */
+#ifndef _ENGINE_H_
+#define _ENGINE_H_
+
+void engine_open( void );
+int engine_command( char * line );
+void engine_close( void );
+
+#endif /* _ENGINE_H_ */
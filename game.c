@@ -2,14 +2,20 @@
  * @brief Provides an implementation of the game of konane
  * @author Eric Watkins, Julian Martinez del Campo, Michael Hnatiw
  */
+#define _POSIX_C_SOURCE 200809L
+
 #include <stdio.h>
 #include <stdlib.h>
 #include <assert.h>
 #include <ctype.h>
 #include <time.h>
+#include <unistd.h>
 
 #include "game.h"
 #include "game_node.h"
+#include "book.h"
+#include "arena.h"
+#include "clock.h"
 #include "move.h"
 #include "state.h"
 #include "konane.h"
@@ -17,8 +23,70 @@
 
 #define INPUT_SIZE  20 
 
-/** Global timer */
-time_t timer;
+/** arena of the computer player's game tree, reset after each move */
+static struct Arena * tree_arena = NULL;
+
+/** 1 if the computer searches during the human's turn */
+static int ponder = 0;
+
+/** the reply the computer expects from the human, if has_prediction */
+static struct Move prediction;
+static int has_prediction = 0;
+
+/**
+ * Let the computer search during the human's turn
+ *
+ * @param enabled 1 to ponder, 0 not to
+ */
+void set_ponder( int enabled )
+{
+    ponder = enabled;
+}
+
+/**
+ * Look the computer's move up in the opening book
+ *
+ * @param game_state the current game state
+ * @return the book's move, or null if the state is not in the book
+ */
+static struct Move * book_move( const struct State * game_state )
+{
+    struct BookEntry entry;
+
+    if( !probe_book( game_state, &entry ) )
+        return NULL;
+
+    printf( "Book move, score %d at depth %d\n", (int) entry.score, (int) entry.depth );
+
+    return clone_move( &entry.move );
+}
+
+/**
+ * Play one of the removals that open the game
+ *
+ * @param game_state the current game state
+ * @param move the piece to remove, freed
+ * @return a new game state
+ */
+static struct State * remove_piece( struct State * game_state, struct Move * move )
+{
+    struct State * state;
+
+    /* print move */
+    printf( "Move chosen: " );
+    print_single_move( move );
+
+    /* create new state */
+    state = clone_state( game_state );
+    state->player = opposite_player( game_state->player );
+
+    /* apply move */
+    set_piece( state, move->start_row, move->start_col, 'O' );
+
+    Free( move );
+
+    return state;
+}
 
 /**
  * Start playing a game of konane
@@ -97,13 +165,13 @@ int human_vs_computer( char *file, char agent_color )
     if( player == state->player )
     {
         temp_state = computer_player_first( state );
-        Free( state, sizeof( struct State ) );
+        Free( state );
         state = temp_state;
     }
     else
     {
         temp_state = human_player_first( state );
-        Free( state, sizeof( struct State ) );
+        Free( state );
         state = temp_state;
     }
 
@@ -113,13 +181,13 @@ int human_vs_computer( char *file, char agent_color )
     if( player == state->player )
     {
         temp_state = computer_player_second( state );
-        Free( state, sizeof( struct State ) );
+        Free( state );
         state = temp_state;
     }
     else
     {
         temp_state = human_player_second( state );
-        Free( state, sizeof( struct State ) );
+        Free( state );
         state = temp_state;
     }
 
@@ -132,13 +200,13 @@ int human_vs_computer( char *file, char agent_color )
         if( state->player == player )
         {
             temp_state = computer_player( state );
-            Free( state, sizeof( struct State ) );
+            Free( state );
             state = temp_state;
         }
         else
         {
             temp_state = human_player( state );
-            Free( state, sizeof( struct State ) );
+            Free( state );
             state = temp_state;
         }
 
@@ -174,14 +242,14 @@ int computer_vs_computer( char *file, char agent_color )
     /* start game */
     print_state( state );
     temp_state = computer_player_first( state );
-    Free( state, sizeof( struct State ) );
+    Free( state );
     state = temp_state;
 
     /* second move */
     printf( "\n" );
     print_state( state );
     temp_state = computer_player_second( state );
-    Free( state, sizeof( struct State ) );
+    Free( state );
     state = temp_state;
 
     /* regular game */
@@ -192,7 +260,7 @@ int computer_vs_computer( char *file, char agent_color )
 
         //printf( "\n>> Mem usage before: %lu\n", memory_usage() );
         temp_state = computer_player( state );
-        Free( state, sizeof( struct State ) );
+        Free( state );
         state = temp_state;
         //printf( "\n>> Mem usage after: %lu\n", memory_usage() );
 
@@ -202,7 +270,7 @@ int computer_vs_computer( char *file, char agent_color )
             print_state( state );
             printf( "\nNo moves left!... \n" );
             printf( "\n%c wins!!!\n", opposite_player( state->player ) );
-            Free( state, sizeof( struct State ) );
+            Free( state );
             break;
         }
     }
@@ -230,24 +298,34 @@ struct State * human_player_first( struct State * game_state )
     do 
     {
         printf( "Please enter a move: " );
+
+        /* think until the human answers */
+        if( ponder && isatty( STDIN_FILENO ) )
+        {
+            fflush( stdout );
+            ponder_search( game_state, has_prediction ? &prediction : NULL );
+            has_prediction = 0;
+        }
+
         fgets( input, INPUT_SIZE, stdin );
 
         move = first_str2move( input );
 
         /* make sure piece is of players color */
-        if( game_state->board[ move->start_row ][ move->start_col ] != 'B' )
+        if( get_piece( game_state, move->start_row, move->start_col ) != 'B' )
         {
             /* invalid move */
-            Free( move, sizeof( struct Move ) );
+            Free( move );
         }
     }
     while( move == NULL );
 
     /* create a new state */
-    state = new_state( game_state->board, opposite_player( game_state->player ) );
+    state = clone_state( game_state );
+    state->player = opposite_player( game_state->player );
 
     /* apply move */
-    state->board[ move->start_row ][ move->start_col ] = 'O';
+    set_piece( state, move->start_row, move->start_col, 'O' );
     print_single_move( move );
 
     return state;
@@ -273,6 +351,15 @@ struct State * human_player_second( struct State * game_state )
     do 
     {
         printf( "Please enter a move: " );
+
+        /* think until the human answers */
+        if( ponder && isatty( STDIN_FILENO ) )
+        {
+            fflush( stdout );
+            ponder_search( game_state, has_prediction ? &prediction : NULL );
+            has_prediction = 0;
+        }
+
         fgets( input, INPUT_SIZE, stdin );
 
         move = first_str2move( input );
@@ -283,7 +370,7 @@ struct State * human_player_second( struct State * game_state )
             if( validate_second_in_move( game_state, move ) == 0 )
             {
                 /* invalid move */
-                Free( move, sizeof( struct Move ) );
+                Free( move );
             }
             else
                 break;
@@ -295,10 +382,11 @@ struct State * human_player_second( struct State * game_state )
     print_single_move( move );
 
     /* create a new state */
-    state = new_state( game_state->board, opposite_player( game_state->player ) );
+    state = clone_state( game_state );
+    state->player = opposite_player( game_state->player );
 
     /* apply move */
-    state->board[ move->start_row ][ move->start_col ] = 'O';
+    set_piece( state, move->start_row, move->start_col, 'O' );
 
     return state;
     
@@ -312,9 +400,15 @@ struct State * human_player_second( struct State * game_state )
  */
 struct State * computer_player_first( struct State * game_state )
 {
-    struct State * state;
     struct Move * move;
 
+    /* the book's removal, if it knows the board */
+    move = book_move( game_state );
+    if( move != NULL && validate_first_in_move( game_state, move ) )
+        return remove_piece( game_state, move );
+    if( move != NULL )
+        Free( move );
+
     srand( time( NULL ) );
 
     do
@@ -326,19 +420,19 @@ struct State * computer_player_first( struct State * game_state )
         {
         case 0:
             /* center top left */
-            move = create_move( 3, 3, 0, 0 );
+            move = create_move( CENTER_LOW, CENTER_LOW, 0, 0 );
             break;
         case 1:
             /* center top right */
-            move = create_move( 3, 4, 0, 0 );
+            move = create_move( CENTER_LOW, CENTER_HIGH, 0, 0 );
             break;
         case 2:
             /* center botom left */
-            move = create_move( 4, 3, 0, 0 );
+            move = create_move( CENTER_HIGH, CENTER_LOW, 0, 0 );
             break;
         case 3:
             /* center bottom right */
-            move = create_move( 4, 4, 0, 0 );
+            move = create_move( CENTER_HIGH, CENTER_HIGH, 0, 0 );
             break;
 #if 1
         case 4:
@@ -347,45 +441,32 @@ struct State * computer_player_first( struct State * game_state )
             break;
         case 5:
             /* corner top right */
-            move = create_move( 0, 7, 0, 0 );
+            move = create_move( 0, EDGE, 0, 0 );
             break;
         case 6:
             /* corner bottom left */
-            move = create_move( 7, 0, 0, 0 );
+            move = create_move( EDGE, 0, 0, 0 );
             break;
         case 7:
             /* corner bottom right */
-            move = create_move( 7, 7, 0, 0 );
+            move = create_move( EDGE, EDGE, 0, 0 );
             break;
 #endif
         }
 
         /* check if move is valid */
-        if( game_state->board[ move->start_row ][ move->start_col ] == 'B' )
+        if( get_piece( game_state, move->start_row, move->start_col ) == 'B' )
         {
             break;
         }
         else
         {
-            Free( move, sizeof( struct Move ) );
+            Free( move );
         }
     }
     while( 1 );
 
-    /* print move */
-    printf( "Move chosen: " );
-    print_single_move( move );
-
-    /* create new state */
-    state = new_state( game_state->board, opposite_player( game_state->player ) );
-
-    /* apply move */
-    state->board[ move->start_row ][ move->start_col ] = 'O';
-
-    Free( move, sizeof( struct Move ) );
-
-    return state;
-
+    return remove_piece( game_state, move );
 }
 
 /**
@@ -396,15 +477,21 @@ struct State * computer_player_first( struct State * game_state )
  */
 struct State * computer_player_second( struct State * game_state )
 {
-    struct State * state;
     struct Move * move;
     int random_move = 0;
     int row, col, i, j;
 
+    /* the book's removal, if it knows the board */
+    move = book_move( game_state );
+    if( move != NULL && get_piece( game_state, move->start_row, move->start_col ) == game_state->player )
+        return remove_piece( game_state, move );
+    if( move != NULL )
+        Free( move );
+
     /* find blank spot */
     for( row = 0; row < SIZE; row++ )
         for( col = 0; col < SIZE; col++ )
-            if( game_state->board[row][col] == 'O' )
+            if( get_piece( game_state, row, col ) == 'O' )
             {
                 i = row;
                 j = col;
@@ -417,8 +504,8 @@ struct State * computer_player_second( struct State * game_state )
     /* valid moves are on either side of empty space */
     if( i == 0 && j == 0 )
     {
-        if( ( game_state->board[ i ][ j + 1 ] == 'W' ) ||
-            ( game_state->board[ i + 1][ j ] == 'W' ) )
+        if( ( get_piece( game_state, i, j + 1 ) == 'W' ) ||
+            ( get_piece( game_state, i + 1, j ) == 'W' ) )
         {
             random_move = rand() % 2;
 
@@ -434,10 +521,10 @@ struct State * computer_player_second( struct State * game_state )
         }
 
     }
-    else if( i == 0 && j == 7 )
+    else if( i == 0 && j == EDGE )
     {
-        if( (game_state->board[ i ][ j - 1 ] == 'W' ) ||
-            (game_state->board[ i + 1 ][ j ] == 'W' ) )
+        if( (get_piece( game_state, i, j - 1 ) == 'W' ) ||
+            (get_piece( game_state, i + 1, j ) == 'W' ) )
         {
             random_move = rand() % 2;
 
@@ -452,10 +539,10 @@ struct State * computer_player_second( struct State * game_state )
             }
         }
     }
-    else if( i == 7 && j == 0 )
+    else if( i == EDGE && j == 0 )
     {
-        if( (game_state->board[ i ][ j + 1 ] == 'W' ) ||
-            (game_state->board[ i - 1 ][ j ] == 'W' ) )
+        if( (get_piece( game_state, i, j + 1 ) == 'W' ) ||
+            (get_piece( game_state, i - 1, j ) == 'W' ) )
         {
             random_move = rand() % 2;
 
@@ -470,10 +557,10 @@ struct State * computer_player_second( struct State * game_state )
             }
         }
     }
-    else if( i == 7 && j == 7 )
+    else if( i == EDGE && j == EDGE )
     {
-        if( (game_state->board[ i ][ j - 1 ] == 'W' ) ||
-            (game_state->board[ i - 1 ][ j ] == 'W' ) )
+        if( (get_piece( game_state, i, j - 1 ) == 'W' ) ||
+            (get_piece( game_state, i - 1, j ) == 'W' ) )
         {
             random_move = rand() % 2;
 
@@ -490,10 +577,10 @@ struct State * computer_player_second( struct State * game_state )
     }
     else
     {
-        if( (game_state->board[ i + 1 ][ j ] == 'W' ) ||
-            (game_state->board[ i - 1 ][ j ] == 'W' ) ||
-            (game_state->board[ i ][ j + 1 ] == 'W' ) ||
-            (game_state->board[ i ][ j - 1 ] == 'W' ) )
+        if( (get_piece( game_state, i + 1, j ) == 'W' ) ||
+            (get_piece( game_state, i - 1, j ) == 'W' ) ||
+            (get_piece( game_state, i, j + 1 ) == 'W' ) ||
+            (get_piece( game_state, i, j - 1 ) == 'W' ) )
         {
             random_move = rand() % 4;
 
@@ -515,18 +602,7 @@ struct State * computer_player_second( struct State * game_state )
         }
     }
 
-    /* print move */
-    printf( "Move chosen: " );
-    print_single_move( move );
-
-    /* create new state */
-    state = new_state( game_state->board, opposite_player( game_state->player ) );
-
-    /* apply move */
-    state->board[ move->start_row ][ move->start_col ] = 'O';
-    Free( move, sizeof( struct Move ) );
-
-    return state;
+    return remove_piece( game_state, move );
 }
 
 /**
@@ -545,6 +621,15 @@ struct State * human_player( struct State * game_state )
     do 
     {
         printf( "Please enter a move: " );
+
+        /* think until the human answers */
+        if( ponder && isatty( STDIN_FILENO ) )
+        {
+            fflush( stdout );
+            ponder_search( game_state, has_prediction ? &prediction : NULL );
+            has_prediction = 0;
+        }
+
         fgets( input, INPUT_SIZE, stdin );
 
         move = str2move( input );
@@ -555,7 +640,7 @@ struct State * human_player( struct State * game_state )
                 break;
             else
             {
-                Free( move, sizeof( struct Move ) );
+                Free( move );
                 move = NULL;
             }
         }
@@ -568,7 +653,7 @@ struct State * human_player( struct State * game_state )
 
     /* create a new state & apply move */
     state = result( game_state, move );
-    Free( move, sizeof( struct Move ) );
+    Free( move );
     state->player = opposite_player( game_state->player );
 
     return state;
@@ -586,19 +671,56 @@ struct State * computer_player( struct State * game_state )
     struct State * state;
     struct Move * move;
     struct GameNode * root;
-    time_t stop;
+    millis start;
+
+    /* an opening the book knows needs no search */
+    move = book_move( game_state );
+    if( move != NULL && validate_action( game_state, move ) )
+    {
+        has_prediction = 0;
+
+        printf( "Move chosen: " );
+        print_move( move );
+
+        state = result( game_state, move );
+        Free( move );
+        state->player = opposite_player( game_state->player );
+
+        return state;
+    }
+    if( move != NULL )
+        Free( move );
 
     /* create a new game node */
-    root = new_game_node( game_state, NULL );
+    if( tree_arena == NULL )
+        tree_arena = new_arena( ARENA_CHUNK_SIZE );
+    root = new_game_node( tree_arena, game_state, NULL );
 
     /* computer player */
-    time( &timer );
+    start = clock_ms();
     move = alpha_beta_search( root );
-    time( &stop );
 
     /* print time */
-    printf( "Time taken: %d\n", stop - timer );
+    printf( "Time taken: %.3f\n", ( clock_ms() - start ) / 1000.0 );
     printf( "Memory used: %lu\n", memory_usage() );
+    printf( "Tree memory used: %lu\n", (unsigned long) arena_used( tree_arena ) );
+    printf( "Depth searched: %d\n", root->depth );
+    printf( "Nodes searched: %lu\n", root->nodes );
+
+    /* print principal variation */
+    printf( "Principal variation:" );
+    for( int i = 0; i < root->pv_length; i++ )
+    {
+        char * pv_move = move2str( &root->pv[ i ] );
+        printf( " %s%s", pv_move, ( i + 1 < root->pv_length ) ? "," : "" );
+        Free( pv_move );
+    }
+    printf( "\n" );
+
+    /* the second move of the principal variation is the expected reply */
+    has_prediction = root->pv_length > 1;
+    if( has_prediction )
+        prediction = root->pv[ 1 ];
 
     /* print move */
     printf( "Move chosen: " );
@@ -606,10 +728,11 @@ struct State * computer_player( struct State * game_state )
 
     /* create a new state and apply move */
     state = result( game_state, move );
-    Free( move, sizeof( struct Move ) );
+    Free( move );
     state->player = opposite_player( game_state->player );
 
-    delete_game_node( &root );
+    /* give back the whole tree at once */
+    reset_arena( tree_arena );
 
     return state;
 }
@@ -10,6 +10,7 @@
 #include "state.h"
 
 int game( char *file, char agent_color );
+void set_ponder( int enabled );
 
 int human_vs_computer( char *file, char agent_color );
 int computer_vs_computer( char *file, char agent_color );
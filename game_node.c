@@ -13,18 +13,23 @@
 /**
  * Create a new game node
  *
+ * Nodes live in an arena, so a whole tree is given back at once by
+ * resetting the arena. A node does not own its state.
+ *
+ * @param arena an arena to allocate the node from
  * @param state a game state
  * @param parent the parent node
  * @return a new game node with state and parent set
  */
-struct GameNode * new_game_node( struct State * state, struct GameNode * parent )
+struct GameNode * new_game_node( struct Arena * arena, struct State * state,
+                                 struct GameNode * parent )
 {
-    struct GameNode * node = Calloc( 1, sizeof( struct GameNode ) );
+    struct GameNode * node = arena_alloc( arena, sizeof( struct GameNode ) );
     assert( node );
 
     node->state = state;
     node->parent = parent;
-    node->children = new_list();
+    node->children = new_list( arena );
 
     return node;
 }
@@ -40,35 +45,3 @@ void add_child_game_node( struct GameNode * parent, struct GameNode * child )
     child->parent = parent;
     add_front( &parent->children, child );
 }
-
-/**
- * Delete a game node
- *
- * @param root a game tree root
- */
-void delete_game_node( struct GameNode ** root )
-{
-    if( *root == NULL )
-        return;
-    
-    /* for each child */
-    if( (*root)->children != NULL )
-    {
-        struct ListNode * current = (*root)->children->head;
-        struct ListNode * temp;
-        while( current != NULL )
-        {
-            struct GameNode * temp_node = current->data;
-            Free( temp_node->state, sizeof( struct State ) );
-            Free( temp_node->best_move, sizeof( struct Move ) );
-
-            delete_game_node( &temp_node );
-
-            current = current->next;
-        }
-        delete_list( &(*root)->children );
-    }
-    
-    Free( *root, sizeof( struct GameNode ) );
-    *root = NULL;
-}
@@ -8,10 +8,10 @@
 #define _GAME_NODE_
 
 #define TREE_DEPTH 3
-#define BOARD_SIZE 8
 
 #include "state.h"
 #include "move.h"
+#include "arena.h"
 
 typedef struct GameNode {
     short int utility_val;
@@ -21,10 +21,14 @@ typedef struct GameNode {
     struct List * children;
     struct Move * best_move;        /**< best move so far */
     short int best_util_val;
+    short int depth;                /**< depth of the last completed search */
+    short int pv_length;            /**< moves in pv */
+    unsigned long nodes;            /**< nodes visited by the last search, by every thread */
+    struct Move pv[ MAX_PLY ];      /**< principal variation of the last completed search */
 } TNode;
 
-struct GameNode * new_game_node( struct State * state, struct GameNode * parent );
+struct GameNode * new_game_node( struct Arena * arena, struct State * state,
+                                 struct GameNode * parent );
 void add_child_game_node( struct GameNode * parent, struct GameNode * child );
-void delete_game_node( struct GameNode ** root );
 
 #endif /* _GAME_NODE_ */
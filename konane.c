@@ -4,232 +4,140 @@
  *
  * Provides an implementation of the game of konane
  */
+#define _POSIX_C_SOURCE 200809L
+
 #include <stdio.h>
 #include <stdlib.h>
 #include <limits.h>
+#include <string.h>
 #include <time.h>
 #include <assert.h>
+#include <pthread.h>
+#include <sched.h>
+#include <poll.h>
+#include <unistd.h>
 
 #include "konane.h"
 #include "state.h"
 #include "move.h"
 #include "list.h"
 #include "game_node.h"
+#include "trans_table.h"
+#include "ordering.h"
+#include "deque.h"
+#include "clock.h"
+#include "timeman.h"
+#include "endgame.h"
+#include "symmetry.h"
 #include "utility.h"
 
 #define MAX_DEPTH 15
-#define MEMORYSIZE 1000000
-#define THINKING_TIME 10
-
-extern time_t timer;
+#define THINKING_TIME 10        /* seconds per move without a game clock */
+#define POLL_NODES 1024         /* nodes between clock readings, a power of two */
+#define ASPIRATION_WINDOW 2     /* half width of the first aspiration window */
+#define ASPIRATION_LIMIT 64     /* widest aspiration window before it is opened */
+#define SPLIT_DRAFT 3           /* fewest plies below a node worth sharing its moves */
+#define IDLE_SPINS 64           /* failed steals before an idle thread sleeps */
+#define SOLVED_SCORE 10000      /* score of a won endgame, beyond any evaluation */
+#define SOLVE_DRAFT 2           /* fewest plies below a node worth solving it */
+
+/** a thread helping the main search */
+struct Helper {
+    pthread_t thread;       /**< the thread running the helper */
+    int id;                 /**< helper number, from 1 */
+    struct State state;     /**< the helper's copy of the root */
+    struct Search search;   /**< the helper's search */
+};
+
+/** transposition table shared by every search */
+static struct TransTable * trans_table = NULL;
+static size_t trans_table_mb = TRANS_TABLE_MB;
+
+/** threads searching each move */
+static int search_threads = 1;
+
+/** deepest iteration of each search */
+static int search_depth = MAX_DEPTH;
+
+/** the clock of each player the computer plays, black first */
+static struct TimeManager time_managers[ 2 ] = {
+    { 0, THINKING_TIME * 1000, 0, 0, 0, 0 },
+    { 0, THINKING_TIME * 1000, 0, 0, 0, 0 }
+};
+
+/** the iterations already searched for the state each player is expected
+ * to move from next, black first */
+static struct GameNode expected_nodes[ 2 ];
+static uint64_t expected_keys[ 2 ];
+static int expected_valid[ 2 ] = { 0, 0 };
+
+/** history of the last search, aged, for the next search to start from */
+static int learned_history[ SIZE * SIZE ][ SIZE * SIZE ];
+
+/** 1 if the threads split the tree, else they only share the table */
+static int search_split = 0;
+
+/** task deque of each thread of a split search */
+static struct Deque ** deques = NULL;
+
+/** set by another thread to stop the running search */
+static int stop_requested = 0;
+
+/** most nodes of a search, 0 for no limit */
+static unsigned long node_limit = 0;
+
+/** called with the root after each completed iteration, or null */
+static void ( * iteration_report )( const struct GameNode * game_state ) = NULL;
 
 static int max( int a, int b );
 static int min( int a, int b );
-static int min_value( struct GameNode * game_state, int depth, int alpha, int beta );
-static int max_value( struct GameNode * game_state, int depth, int alpha, int beta );
-
-/**
- * Find possible actions right on a row
- *
- * @param state a game state
- * @param row the row to check
- * @return a list of actions
- */
-static struct List * actions_right( const struct State * state, int row )
-{
-    int idx = 0;
-    struct List * actions = new_list();
-    
-    for(idx = 0; (idx < SIZE) && ((idx + 2) < SIZE); idx++){
-      if( (state->board[ row ][idx] == state->player )
-	    && (state->board[ row ][ idx + 1 ] == opposite_player( state->player ))
-	    && (state->board[ row ][ idx + 2 ] == 'O')){
-	   /* check for moves  - increment to optimize move*/
-	   int end_col = idx + 2;	   
-	   /* add move to action list for single jump  */
-	   add_front( &actions, create_move( row, idx, row, end_col) );
-	   while( ((end_col + 2) < SIZE )
-	        && (state->board[ row ][ end_col ] == 'O' )
-	        && (state->board[ row ][ end_col + 1 ] == opposite_player( state->player ))
-	        && (state->board[ row ][ end_col + 2 ] == 'O') ){
-	     end_col += 2;
-	     /* add optimized moves to action list */
-	     add_front( &actions, create_move( row, idx, row, end_col) );
-	   }
-      }
-    }
-    
-    return actions;
-}
-
-/**
- * Find possible actions left on a row
- *
- * @param state a game state
- * @param row the row to check
- * @return a list of actions
- */
-static struct List * actions_left( const struct State * state, int row )
-{
-    int idx = SIZE-1;
-    struct List * actions = new_list();
-
-     for(idx = SIZE - 1; (idx > 0) && ((idx - 2) >= 0); idx--){
-       if( (state->board[ row ][idx] == state->player )
-	    && (state->board[ row ][ idx - 1 ] == opposite_player( state->player ))
-	    && (state->board[ row ][ idx - 2 ] == 'O')){
-	   /* check for moves  - increment to optimize move*/
-	   int end_col = idx - 2;
-	   /* add move to action list for single jump  */
-	   add_front( &actions, create_move( row, idx, row, end_col) );
-	   while( ((end_col - 2) > 0 )
-	        && (state->board[ row ][ end_col ] == 'O' )
-	        && (state->board[ row ][ end_col - 1 ] == opposite_player( state->player ))
-	        && (state->board[ row ][ end_col - 2 ] == 'O') ){
-	     end_col -= 2;
-	     /* add optimized moves to action list */ 
-	     add_front( &actions, create_move( row, idx, row, end_col) );
-	   }
-       }
-     }
-
-    return actions;
-}
-
-/**
- * Find possible actions down on a column
- *
- * @param state a game state
- * @param col the column to check
- * @return a list of actions
- */
-static struct List * actions_down( const struct State * state, int col )
-{
-    int idx = 0;
-    struct List * actions = new_list();
-
-    for(idx = 0; (idx < SIZE) && ((idx + 2) < SIZE); idx++){
-      if(  (state->board[ idx ][col] == state->player )
-	    && (state->board[ idx + 1 ][ col ] == opposite_player( state->player ))
-	    && (state->board[ idx + 2 ][ col ] == 'O')){
-	   /* check for moves  - increment to optimize move*/
-	   int end_row = idx + 2;
-	   /* add move to action list for single jump  */
-	   add_front( &actions, create_move( idx, col, end_row, col) );
-	   while( ((end_row + 2) < SIZE )
-	        && (state->board[ end_row ][ col ] == 'O' )
-	        && (state->board[ end_row + 1 ][ col ] == opposite_player( state->player ))
-	        && (state->board[ end_row + 2 ][ col ] == 'O') ){
-	     end_row += 2;
-	     /* add optimized moves to action list */
-	     add_front( &actions, create_move( idx, col, end_row, col) );
-	   }
-      }
-    }
-    
-    return actions;
-}
-
-/**
- * Find possible actions up on a column
- *
- * @param state a game state
- * @param col the column to check
- * @return a list of actions
- */
-static struct List * actions_up( const struct State * state, int col )
-{
-    int idx = SIZE - 1;
-    struct List * actions = new_list();
-
-    for(idx = SIZE - 1; (idx > 0) && ((idx - 2) >= 0); idx--){
-      if(  (state->board[ idx ][col] == state->player )
-	    && (state->board[ idx - 1 ][ col ] == opposite_player( state->player ))
-	    && (state->board[ idx - 2 ][ col ] == 'O')){
-	   /* check for moves  - increment to optimize move*/
-	   int end_row = idx - 2;
-	   /* add move to action list for single jump  */
-	   add_front( &actions, create_move( idx, col, end_row, col) );
-	   while( ((end_row - 2) > 0 )
-	        && (state->board[ end_row ][ col ] == 'O' )
-	        && (state->board[ end_row - 1 ][ col ] == opposite_player( state->player ))
-	        && (state->board[ end_row - 2 ][ col ] == 'O') ){
-	     end_row -= 2;
-	     /* add optimized moves to action list */
-	     add_front( &actions, create_move( idx, col, end_row, col) );
-	   }
-      }
-    }
-
-    return actions;
-}
+static int min_value( struct Search * search, struct State * state, int ply, int alpha, int beta );
+static int max_value( struct Search * search, struct State * state, int ply, int alpha, int beta );
 
 /**
  * Find all possible actions/moves in a state
  *
+ * Single jumps in each direction are found for every piece at once by
+ * shifting the player's mask over the opponent's mask onto the empty mask.
+ * Jumping again from the landing squares extends each chain by one jump.
+ *
  * @param state a state to check for moves
- * @return a list of actions/moves
+ * @param moves a move list to fill with actions/moves
+ * @return the number of actions/moves found
  */
-struct List * actions( const struct State * state )
+int actions( const struct State * state, struct MoveList * moves )
 {
+    bitboard own = player_pieces( state, state->player );
+    bitboard other = player_pieces( state, opposite_player( state->player ) );
+    bitboard empty = empty_squares( state );
 
-    struct List * moves = new_list();
-    struct List * temp_moves;
-    struct ListNode * current;
+    moves->count = 0;
 
-    /* combine all actions */
-    for( int i = 0; i < SIZE; i++ )
+    for( int direction = 0; direction < DIRECTIONS; direction++ )
     {
-        /* actions right */
-        temp_moves = actions_right( state, i );
-
-        current = temp_moves->head; 
-        while( current != NULL )
-        {
-            add_front( &moves, current->data );
-            current = current->next;
-        }
-
-        delete_list( &temp_moves );
-
-        /* actions left */
-        temp_moves = actions_left( state, i );
-
-        current = temp_moves->head; 
-        while( current != NULL )
-        {
-            add_front( &moves, current->data );
-            current = current->next;
-        }
-
-        delete_list( &temp_moves );
-
-        /* actions up */
-        temp_moves = actions_up( state, i );
+        bitboard landings = jumps( own, other, empty, direction );
 
-        current = temp_moves->head; 
-        while( current != NULL )
+        for( int length = 2; !bb_none( landings ); length += 2 )
         {
-            add_front( &moves, current->data );
-            current = current->next;
-        }
-
-        delete_list( &temp_moves );
-
-        /* actions down */
-        temp_moves = actions_down( state, i );
+            bitboard current = landings;
+            while( !bb_none( current ) )
+            {
+                int end = pop_square( &current );
+                int start = end - length * direction_offset[ direction ];
+
+                struct Move * move = &moves->moves[ moves->count++ ];
+                move->start_row = start / SIZE;
+                move->start_col = start % SIZE;
+                move->end_row = end / SIZE;
+                move->end_col = end % SIZE;
+            }
 
-        current = temp_moves->head; 
-        while( current != NULL )
-        {
-            add_front( &moves, current->data );
-            current = current->next;
+            /* continue each chain with another jump in the same direction */
+            landings = jumps( landings, other, empty, direction );
         }
-
-        delete_list( &temp_moves );
     }
 
-    return moves;
+    return moves->count;
 }
 
 /**
@@ -244,136 +152,238 @@ struct List * actions( const struct State * state )
  */
 struct State * result( const struct State * state, const struct Move * action )
 {
-    char new_board[SIZE][SIZE];
-    
-    /* copy old board */
-    for( int i = 0; i < SIZE; i++ )
-        for( int j = 0; j < SIZE; j++ )
-            new_board[ i ][ j ] = state->board[ i ][ j ];
-
     /* validate move */ 
     if( validate_action( state, action ) )
     {
-        /* get resulting board state 
-         * by removing all pieces between start and end action 
-         */
-        if( action->start_row == action->end_row )
-        {
-            /* blank column */
-            if( action->start_col < action->end_col )
-                for( int i = action->start_col; i < action->end_col; i++ )
-                    new_board[ action->start_row ][ i ] = 'O';
-            else
-                for( int i = action->start_col; i > action->end_col; i-- )
-                    new_board[ action->start_row ][ i ] = 'O';
-        }
-        else
-        {
-            /* blank row */
-            if( action->start_row < action->end_row )
-                for( int i = action->start_row; i < action->end_row; i++ )
-                    new_board[ i ][ action->start_col ] = 'O';
-            else
-                for( int i = action->start_row; i > action->end_row; i-- )
-                    new_board[ i ][ action->start_col ] = 'O';
-        }
-
-        /* set current piece */
-        new_board[ action->end_row ][ action->end_col ] = state->player;
+        struct State * next = clone_state( state );
+        make_move( next, action );
 
-        /* return changed board */
-        return new_state( new_board, opposite_player( state->player ) );
+        return next;
     }
 
     return NULL;
 }
 
 /**
- * Validate an action
+ * Find the step along a move's line
  *
- * @param state a state to check
- * @param action a move to perform
- * @return 1 if action is valid, else return 0
+ * @param action a move
+ * @return the square index offset of one step from start towards end, or 0
+ *  if action does not travel an even, non-zero distance along a row or column
  */
-int validate_action( const struct State * state, const struct Move * action )
+static int move_step( const struct Move * action )
 {
-    struct List * moves = new_list();
-    struct List * temp_moves;
-    struct ListNode * current;
-    int is_valid = 0;
+    int rows = action->end_row - action->start_row;
+    int cols = action->end_col - action->start_col;
 
-    /* combine all actions */
-    for( int i = 0; i < SIZE; i++ )
-    {
-        /* actions right */
-        temp_moves = actions_right( state, i );
+    if( rows == 0 && cols != 0 && cols % 2 == 0 )
+        return ( cols > 0 ) ? 1 : -1;
+    if( cols == 0 && rows != 0 && rows % 2 == 0 )
+        return ( rows > 0 ) ? SIZE : -SIZE;
 
-        current = temp_moves->head; 
-        while( current != NULL )
-        {
-            add_front( &moves, current->data );
-            current = current->next;
-        }
+    return 0;
+}
 
-        delete_list( &temp_moves );
+/**
+ * Find the squares a move jumps over
+ *
+ * @param action a valid move
+ * @return the squares holding the pieces captured by action
+ */
+static bitboard captured_squares( const struct Move * action )
+{
+    int start = BB_INDEX( action->start_row, action->start_col );
+    int end = BB_INDEX( action->end_row, action->end_col );
+    int step = move_step( action );
+    bitboard captured = BB_EMPTY;
 
-        /* actions left */
-        temp_moves = actions_left( state, i );
+    for( int i = start; i != end; i += 2 * step )
+        captured = bb_or( captured, bb_square( i + step ) );
 
-        current = temp_moves->head; 
-        while( current != NULL )
-        {
-            add_front( &moves, current->data );
-            current = current->next;
-        }
+    return captured;
+}
 
-        delete_list( &temp_moves );
+/**
+ * Apply a move to a state in place
+ *
+ * Only the start, end and captured squares change, and the player to move
+ * passes to the opponent.
+ *
+ * @pre action is valid in state
+ * @param state a state to change
+ * @param action the move to apply
+ * @return what unmake_move() needs to take the move back
+ */
+struct Undo make_move( struct State * state, const struct Move * action )
+{
+    struct Undo undo;
+    int start = BB_INDEX( action->start_row, action->start_col );
+    int end = BB_INDEX( action->end_row, action->end_col );
+    bitboard moved = bb_or( bb_square( start ), bb_square( end ) );
+    char other = opposite_player( state->player );
 
-        /* actions up */
-        temp_moves = actions_up( state, i );
+    undo.captured = captured_squares( action );
+    memcpy( undo.hash, state->hash, sizeof( undo.hash ) );
 
-        current = temp_moves->head; 
-        while( current != NULL )
-        {
-            add_front( &moves, current->data );
-            current = current->next;
-        }
+    if( state->player == 'B' )
+    {
+        state->black = bb_xor( state->black, moved );
+        state->white = bb_xor( state->white, undo.captured );
+    }
+    else
+    {
+        state->white = bb_xor( state->white, moved );
+        state->black = bb_xor( state->black, undo.captured );
+    }
 
-        delete_list( &temp_moves );
+    /* update the keys of each square that changed */
+    toggle_piece( state->hash, state->player, start );
+    toggle_piece( state->hash, state->player, end );
+    for( bitboard captured = undo.captured; !bb_none( captured ); )
+        toggle_piece( state->hash, other, pop_square( &captured ) );
 
-        /* actions down */
-        temp_moves = actions_down( state, i );
+    state->player = other;
 
-        current = temp_moves->head; 
-        while( current != NULL )
-        {
-            add_front( &moves, current->data );
-            current = current->next;
-        }
+    return undo;
+}
+
+/**
+ * Take back a move applied by make_move()
+ *
+ * @param state the state the move was applied to
+ * @param action the move to take back
+ * @param undo the value make_move() returned for action
+ */
+void unmake_move( struct State * state, const struct Move * action, struct Undo undo )
+{
+    bitboard moved = bb_or( BB_SQUARE( action->start_row, action->start_col ),
+                            BB_SQUARE( action->end_row, action->end_col ) );
 
-        delete_list( &temp_moves );
+    state->player = opposite_player( state->player );
+
+    if( state->player == 'B' )
+    {
+        state->black = bb_xor( state->black, moved );
+        state->white = bb_xor( state->white, undo.captured );
     }
+    else
+    {
+        state->white = bb_xor( state->white, moved );
+        state->black = bb_xor( state->black, undo.captured );
+    }
+
+    memcpy( state->hash, undo.hash, sizeof( state->hash ) );
+}
+
+#ifdef DEBUG_VALIDATE
+/**
+ * Validate an action by searching every possible action
+ *
+ * @param state a state to check
+ * @param action a move to perform
+ * @return 1 if action is valid, else return 0
+ */
+static int validate_action_by_search( const struct State * state, const struct Move * action )
+{
+    struct MoveList moves;
+    actions( state, &moves );
 
     /* check if moves is in possible actions */
-    struct Move * move;
-    current = moves->head;
-    while( current != NULL )
+    for( int i = 0; i < moves.count; i++ )
+        if( compare_move( &moves.moves[ i ], action ) == 1 )
+            return 1;
+
+    return 0;
+}
+#endif
+
+/**
+ * Validate an action
+ *
+ * Only the squares on the move's line are checked: the start square must
+ * hold the player's piece, then each jump must pass an opponent's piece and
+ * land on an empty square. Build with -DDEBUG_VALIDATE to cross-check the
+ * answer against full move generation.
+ *
+ * @param state a state to check
+ * @param action a move to perform
+ * @return 1 if action is valid, else return 0
+ */
+int validate_action( const struct State * state, const struct Move * action )
+{
+    int is_valid = 0;
+    int step = move_step( action );
+
+    if( step != 0 &&
+        action->start_row >= 0 && action->start_row < SIZE &&
+        action->start_col >= 0 && action->start_col < SIZE &&
+        action->end_row >= 0 && action->end_row < SIZE &&
+        action->end_col >= 0 && action->end_col < SIZE )
     {
-        move = current->data;
-        if( compare_move( move, action ) == 1 )
-        {
-            is_valid = 1;
-        }
-        current = current->next;
+        bitboard other = player_pieces( state, opposite_player( state->player ) );
+        bitboard empty = empty_squares( state );
+        int start = BB_INDEX( action->start_row, action->start_col );
+        int end = BB_INDEX( action->end_row, action->end_col );
 
-        Free( move, sizeof( struct Move ) );
+        is_valid = bb_test( player_pieces( state, state->player ), start );
+
+        for( int i = start; is_valid && i != end; i += 2 * step )
+            is_valid = bb_test( other, i + step ) && bb_test( empty, i + 2 * step );
     }
 
-    delete_list( &moves );
+#ifdef DEBUG_VALIDATE
+    assert( is_valid == validate_action_by_search( state, action ) );
+#endif
 
     return is_valid;
 }
 
+/**
+ * Check if the current player can move
+ *
+ * Every move starts with a single jump, so the single jump masks of the
+ * four directions are tested together without generating any move.
+ *
+ * @param state a state to check
+ * @return 1 if the current player has a move, else return 0
+ */
+int has_moves( const struct State * state )
+{
+    bitboard own = player_pieces( state, state->player );
+    bitboard other = player_pieces( state, opposite_player( state->player ) );
+    bitboard empty = empty_squares( state );
+
+    return !bb_none( bb_or( bb_or( jumps( own, other, empty, RIGHT ), jumps( own, other, empty, LEFT ) ),
+                            bb_or( jumps( own, other, empty, DOWN ), jumps( own, other, empty, UP ) ) ) );
+}
+
+/**
+ * Count the moves of the current player without generating them
+ *
+ * @param state a state to check
+ * @return the number of moves actions() would find
+ */
+int count_moves( const struct State * state )
+{
+    bitboard own = player_pieces( state, state->player );
+    bitboard other = player_pieces( state, opposite_player( state->player ) );
+    bitboard empty = empty_squares( state );
+    int count = 0;
+
+    for( int direction = 0; direction < DIRECTIONS; direction++ )
+    {
+        bitboard landings = jumps( own, other, empty, direction );
+
+        while( !bb_none( landings ) )
+        {
+            count += popcount( landings );
+            landings = jumps( landings, other, empty, direction );
+        }
+    }
+
+    return count;
+}
+
 /**
  * Check if the game is over
  *
@@ -383,101 +393,31 @@ int validate_action( const struct State * state, const struct Move * action )
 int terminal_test( const struct State * state )
 {
     /* if there are no more moves for other player, game is done */
-    struct List * moves = actions( state );
-
-    /* check if state is terminal */
-    int has_move = ( moves->count == 0 );
-
-    struct ListNode * current = moves->head;
-    struct Move * move;
-
-    while( current != NULL )
-    {
-        move = current->data;
-        Free( move, sizeof( struct Move ) );
-
-        current = current->next;
-    }
-    delete_list( &moves );
-
-    return has_move;
-}
-
-//will evaluate the board and return a number based on the
-//number of moves an enemy has
-static int evaluation (char fcolor, char ecolor, char board[][BOARD_SIZE]) {
-  int count = 0, counter = 0;
-  int size=BOARD_SIZE;
-  int tc=0;
-   
- //goes through the board horizontally
- while(count<size){
-     while(counter<size){
-       if(counter+2<size){
-	 if((ecolor==board[count][counter])
-	    && (fcolor==board[count][counter+1])
-	    && (board[count][counter+2]=='O'))
-	   { 
-	     tc=tc+1; 
-	   }
-       }
-       if(counter-2>=0){
-	 if((ecolor==board[count][counter])
-	    && (fcolor==board[count][counter-1])
-	    && (board[count][counter-2]=='O')) 
-	   {
-	     tc=tc+1;
-	   }
-       }
-       //printf("count: %d counter: %d\n",count,counter);
-       counter++;
-     }
-     counter=0;
-    count++;
- }
-
- count=0;
- counter=0;
- //goes through the board vertically
- while(counter<size){
-   while(count<size){
-     if(count+2<size){
-       if((ecolor==board[count][counter])
-	  && (fcolor==board[count+1][counter])
-	  && (board[count+2][counter]=='O'))
-	 {
-	   tc=tc+1;
-	 }
-     }
-     if(count-2>=0){
-       if((ecolor==board[count][counter])
-	  && (fcolor==board[count-1][counter])
-	  && (board[count-2][counter]=='O'))
-	 {
-	   tc=tc+1;
-	 }
-     }
-
-     //printf("count: %d counter: %d\n",count,counter);
-     count++;
-   }
-   count=0;
-   counter++;
- }
- 
- return tc;
-}
-
-/**
- * Call the evaluation function
+    return !has_moves( state );
+}
+
+/**
+ * Evaluate a state
+ *
+ * The utility is the current player's mobility minus the opponent's, where
+ * mobility is the number of single jumps a player could make. Both players'
+ * jumps are counted in one pass over the four directions with masks.
  *
  * @param state a state to evaluate
  * @return the utility value of the state
  */
 int eval( struct State * state )
 {
-    return evaluation( opposite_player( state->player), state->player, state->board ) - 
-           evaluation( state->player, opposite_player( state->player ), state->board );
+    bitboard own = player_pieces( state, state->player );
+    bitboard other = player_pieces( state, opposite_player( state->player ) );
+    bitboard empty = empty_squares( state );
+    int utility = 0;
+
+    for( int direction = 0; direction < DIRECTIONS; direction++ )
+        utility += popcount( jumps( own, other, empty, direction ) ) -
+                   popcount( jumps( other, own, empty, direction ) );
+
+    return utility;
 }
 
 /**
@@ -502,16 +442,16 @@ char opposite_player( char player )
  */
 int validate_first_in_move( const struct State * state, const struct Move * action )
 {
-    if( ((action->start_row == 3) && (action->start_col == 3)) ||
-        ((action->start_row == 3) && (action->start_col == 4)) ||
-        ((action->start_row == 4) && (action->start_col == 3)) ||
-        ((action->start_row == 4) && (action->start_col == 4)) ||
+    if( ((action->start_row == CENTER_LOW) && (action->start_col == CENTER_LOW)) ||
+        ((action->start_row == CENTER_LOW) && (action->start_col == CENTER_HIGH)) ||
+        ((action->start_row == CENTER_HIGH) && (action->start_col == CENTER_LOW)) ||
+        ((action->start_row == CENTER_HIGH) && (action->start_col == CENTER_HIGH)) ||
         ((action->start_row == 0) && (action->start_col == 0)) ||
-        ((action->start_row == 0) && (action->start_col == 7)) ||
-        ((action->start_row == 7) && (action->start_col == 0)) ||
-        ((action->start_row == 7) && (action->start_col == 7)) ) 
+        ((action->start_row == 0) && (action->start_col == EDGE)) ||
+        ((action->start_row == EDGE) && (action->start_col == 0)) ||
+        ((action->start_row == EDGE) && (action->start_col == EDGE)) ) 
     {
-        if( state->board[ action->start_row ][ action->start_col ] == 'B' )
+        if( get_piece( state, action->start_row, action->start_col ) == 'B' )
             return 1;
     }
 
@@ -533,7 +473,7 @@ int validate_second_in_move( const struct State * state, const struct Move * act
     /* find empty space on board */
     for( row = 0; row < SIZE; row++ )
         for( col = 0; col < SIZE; col++ )
-            if( state->board[ row ][ col ] == 'O' )
+            if( get_piece( state, row, col ) == 'O' )
             {
                 i = row;
                 j = col;
@@ -542,40 +482,92 @@ int validate_second_in_move( const struct State * state, const struct Move * act
     /* valid moves are on either side of empty space */
     if( i == 0 && j == 0 )
     {
-        if( ( state->board[ i ][ j + 1 ] == 'W' ) ||
-            ( state->board[ i + 1][ j ] == 'W' ) )
+        if( ( get_piece( state, i, j + 1 ) == 'W' ) ||
+            ( get_piece( state, i + 1, j ) == 'W' ) )
             return 1;
     }
-    else if( i == 0 && j == 7 )
+    else if( i == 0 && j == EDGE )
     {
-        if( (state->board[ i ][ j - 1 ] == 'W' ) ||
-            (state->board[ i + 1 ][ j ] == 'W' ) )
+        if( (get_piece( state, i, j - 1 ) == 'W' ) ||
+            (get_piece( state, i + 1, j ) == 'W' ) )
             return 1;
     }
-    else if( i == 7 && j == 0 )
+    else if( i == EDGE && j == 0 )
     {
-        if( (state->board[ i ][ j + 1 ] == 'W' ) ||
-            (state->board[ i - 1 ][ j ] == 'W' ) )
+        if( (get_piece( state, i, j + 1 ) == 'W' ) ||
+            (get_piece( state, i - 1, j ) == 'W' ) )
             return 1;
     }
-    else if( i == 7 && j == 7 )
+    else if( i == EDGE && j == EDGE )
     {
-        if( (state->board[ i ][ j - 1 ] == 'W' ) ||
-            (state->board[ i - 1 ][ j ] == 'W' ) )
+        if( (get_piece( state, i, j - 1 ) == 'W' ) ||
+            (get_piece( state, i - 1, j ) == 'W' ) )
             return 1;
     }
     else
     {
-        if( (state->board[ i + 1 ][ j ] == 'W' ) ||
-            (state->board[ i - 1 ][ j ] == 'W' ) ||
-            (state->board[ i ][ j + 1 ] == 'W' ) ||
-            (state->board[ i ][ j - 1 ] == 'W' ) )
+        if( (get_piece( state, i + 1, j ) == 'W' ) ||
+            (get_piece( state, i - 1, j ) == 'W' ) ||
+            (get_piece( state, i, j + 1 ) == 'W' ) ||
+            (get_piece( state, i, j - 1 ) == 'W' ) )
             return 1;
     }
 
     return 0;
 }
 
+/**
+ * List the removals open to the player to move
+ *
+ * Black first removes a piece from the centre or a corner, then white a
+ * piece next to the empty square.
+ *
+ * @param state a state with at most one empty square
+ * @param moves set to the removals, start and end the removed square
+ * @return the number of removals, at most MAX_REMOVALS
+ */
+int removals( const struct State * state, struct Move moves[] )
+{
+    static const int first[ MAX_REMOVALS ][ 2 ] = {
+        { CENTER_LOW, CENTER_LOW }, { CENTER_LOW, CENTER_HIGH },
+        { CENTER_HIGH, CENTER_LOW }, { CENTER_HIGH, CENTER_HIGH },
+        { 0, 0 }, { 0, EDGE }, { EDGE, 0 }, { EDGE, EDGE }
+    };
+    static const int next[ 4 ][ 2 ] = { { -1, 0 }, { 1, 0 }, { 0, -1 }, { 0, 1 } };
+    int count = 0;
+
+    if( bb_none( empty_squares( state ) ) )
+    {
+        for( int i = 0; i < MAX_REMOVALS; i++ )
+            if( get_piece( state, first[ i ][ 0 ], first[ i ][ 1 ] ) == state->player )
+            {
+                struct Move move = { first[ i ][ 0 ], first[ i ][ 1 ], first[ i ][ 0 ], first[ i ][ 1 ] };
+                moves[ count++ ] = move;
+            }
+
+        return count;
+    }
+
+    int square = BB_INDEX( 0, 0 );
+    for( bitboard empty = empty_squares( state ); !bb_none( empty ); )
+        square = pop_square( &empty );
+
+    for( int i = 0; i < 4; i++ )
+    {
+        int row = square / SIZE + next[ i ][ 0 ];
+        int col = square % SIZE + next[ i ][ 1 ];
+
+        if( row >= 0 && row < SIZE && col >= 0 && col < SIZE &&
+            get_piece( state, row, col ) == state->player )
+        {
+            struct Move move = { row, col, row, col };
+            moves[ count++ ] = move;
+        }
+    }
+
+    return count;
+}
+
 /**
  * Get max of a or b
  *
@@ -601,197 +593,1261 @@ static int min( int a, int b )
 }
 
 /**
- * Max of alpha beta
+ * Check if a split point or one of its ancestors has been cut off
  *
- * @param game_state the current game tree state
- * @param depth the depth of the tree
- * @param alpha
- * @param beta
- * @return a utility value
+ * @param split a split point, or null
+ * @return 1 if the moves below split are not needed, else return 0
  */
-static int max_value( struct GameNode * game_state, int depth, int alpha, int beta )
+static int split_aborted( const struct SplitPoint * split )
 {
-    time_t current_time;
-    time( &current_time );
-
-    if( ( (current_time - timer) > THINKING_TIME - 1 ) ||
-           cutoff_test( game_state->state, depth ) ||
-           memory_usage() > MEMORYSIZE )
-    {
-        return eval( game_state->state );
-    }
-    struct ListNode * current_b;
-
-    ++depth;
-    int v = INT_MIN;
-    int min_val;
-
-    struct List * a = actions( game_state->state ); /* get possible actions */
-    /* iterate over all moves */
-    struct ListNode * current = a->head;
-    while( current != NULL )
-    {
-        /* create new game node */
-        struct State * state = result( game_state->state, current->data );
-        struct GameNode * node = new_game_node( state, game_state );
-
-        add_child_game_node( game_state, node );
-
-        /* find max value */
-        min_val = min_value( node, depth, alpha, beta );
+    for( ; split != NULL; split = split->parent )
+        if( __atomic_load_n( &split->aborted, __ATOMIC_RELAXED ) )
+            return 1;
 
-        if( min_val > v )
-        {
-            game_state->best_util_val = v;
-            if( game_state->best_move != NULL )
-                Free( game_state->best_move, sizeof( struct Move ) );
-            game_state->best_move = clone_move( current->data );
-        }
+    return 0;
+}
 
-        v = max( v, min_val );
+/**
+ * Check if input is waiting on stdin
+ *
+ * @return 1 if reading stdin would not block, else return 0
+ */
+static int input_pending( void )
+{
+    struct pollfd input = { STDIN_FILENO, POLLIN, 0 };
 
-        if( v >= beta )
-        {
-            if( game_state->best_move != NULL )
-                Free( game_state->best_move, sizeof( struct Move ) );
-            game_state->best_move = clone_move( current->data );
+    return poll( &input, 1, 0 ) > 0;
+}
 
-            /* free list of actions except for best move */
-            current_b = a->head;
-            while( current_b != NULL )
-            {
-                Free( current_b->data, sizeof( struct Move ) );
-                current_b = current_b->next;
-            }
+/**
+ * Check if the search must stop
+ *
+ * The clock is read only every POLL_NODES nodes of a thread, and so is
+ * stdin while pondering. When time runs out, input arrives, a thread uses
+ * up its share of the node limit or another thread asks for a stop, every
+ * thread of the search is stopped. A thread searching a
+ * move of a split point that was cut off is stopped too.
+ *
+ * @param search the running search
+ * @return 1 if the search must stop, else return 0
+ */
+static int time_is_up( struct Search * search )
+{
+    if( ( search->nodes & ( POLL_NODES - 1 ) ) == 0 &&
+        ( clock_ms() >= search->deadline || ( search->pondering && input_pending() ) ||
+          ( node_limit > 0 && search->nodes * search_threads >= node_limit ) ||
+          __atomic_load_n( &stop_requested, __ATOMIC_RELAXED ) ) )
+        __atomic_store_n( search->stop_all, 1, __ATOMIC_RELAXED );
 
-            delete_list( &a );
-            return v;
-        }
+    if( __atomic_load_n( search->stop_all, __ATOMIC_RELAXED ) ||
+        split_aborted( search->split ) )
+        search->stopped = 1;
 
-        alpha = max( alpha, v );
-        
-        current = current->next;
-    }
+    return search->stopped;
+}
 
-    /* free list of actions */
-    current_b = a->head;
-    while( current_b != NULL )
-    {
-        Free( current_b->data, sizeof( struct Move ) );
-        current_b = current_b->next;
-    }
+/**
+ * Switch a transposition between the current player's view and the
+ * opponent's
+ *
+ * @param entry a transposition to flip
+ */
+static void flip_view( struct Transposition * entry )
+{
+    entry->score = -entry->score;
 
-    delete_list( &a );
-    return v;
+    if( entry->bound == BOUND_LOWER )
+        entry->bound = BOUND_UPPER;
+    else if( entry->bound == BOUND_UPPER )
+        entry->bound = BOUND_LOWER;
 }
 
 /**
- * Min of alpha beta
+ * Check if a stored result decides a node
  *
- * @param game_state the current game tree state
- * @param depth the depth of the tree
+ * @param entry a transposition, from the max player's view
+ * @param draft the plies left to search below the node
  * @param alpha
  * @param beta
- * @return a utility value
+ * @return 1 if entry's score can be returned for the node, else return 0
  */
-static int min_value( struct GameNode * game_state, int depth, int alpha, int beta )
+static int table_cutoff( const struct Transposition * entry, int draft, int alpha, int beta )
 {
-    time_t current_time;
-    time( &current_time );
+    if( entry->depth < draft )
+        return 0;
 
-    if( ( (current_time - timer) > THINKING_TIME - 1 ) ||
-           cutoff_test( game_state->state, depth ) ||
-           memory_usage() > MEMORYSIZE )
-        return eval( game_state->state );
+    return entry->bound == BOUND_EXACT ||
+           ( entry->bound == BOUND_LOWER && entry->score >= beta ) ||
+           ( entry->bound == BOUND_UPPER && entry->score <= alpha );
+}
 
-    ++depth;
-    int v = INT_MAX;
-    int max_val;
-    struct ListNode * current_b;
+/**
+ * Store a node's result in the transposition table
+ *
+ * Scores are stored from the view of the player to move at the node, so an
+ * entry stays valid whichever player the search is run for.
+ *
+ * @param search the running search
+ * @param state the node's state
+ * @param draft the plies searched below the node
+ * @param v the node's value, from the max player's view
+ * @param alpha alpha when the node was entered
+ * @param beta beta when the node was entered
+ * @param best_move the best move found at the node
+ * @param maximizing 1 if the max player is to move at the node
+ */
+static void store_result( struct Search * search, const struct State * state, int draft,
+                          int v, int alpha, int beta, const struct Move * best_move,
+                          int maximizing )
+{
+    struct Transposition entry;
+
+    entry.depth = draft;
+    entry.score = v;
+    if( v <= alpha )
+        entry.bound = BOUND_UPPER;
+    else if( v >= beta )
+        entry.bound = BOUND_LOWER;
+    else
+        entry.bound = BOUND_EXACT;
+    entry.has_move = 1;
+    entry.move = *best_move;
 
-    struct List * a = actions( game_state->state ); /* get possible actions */
-    /* iterate over all actions */
-    struct ListNode * current = a->head;
-    while( current != NULL )
-    {
-        /* create new game node */
-        struct State * state = result( game_state->state, current->data );
-        struct GameNode * node = new_game_node( state, game_state );
-        add_child_game_node( game_state, node );    /* add child node */
+    if( !maximizing )
+        flip_view( &entry );
 
-        max_val = max_value( node, depth, alpha, beta );
-        if( max_val < v )
-        {
-            game_state->best_util_val = v;
-            if( game_state->best_move != NULL )
-                Free( game_state->best_move, sizeof( struct Move ) );
-            game_state->best_move = clone_move( current->data );
-        }
+    /* mirrored positions share the entry, its move is in their canonical orientation */
+    int symmetry;
+    uint64_t key = canonical_key( state, &symmetry );
+    transform_move( &entry.move, symmetry );
 
-        v = min( v, max_val );
+    store_trans_table( search->table, key, &entry );
+}
 
-        if( v <= alpha )
-        {
-            if( game_state->best_move != NULL )
-                Free( game_state->best_move, sizeof( struct Move ) );
-            game_state->best_move = clone_move( current->data );
-            /* free list of actions except for chosen action */
-            current_b = a->head;
-            while( current_b != NULL )
-            {
-                Free( current_b->data, sizeof( struct Move ) );
-                current_b = current_b->next;
-            }
-            delete_list( &a );
-            return v;
-        }
+/**
+ * Look up the result stored for a node, or for any of its mirror images
+ *
+ * @param search the running search
+ * @param state the node's state
+ * @param entry set to the stored result, its move turned to the state's
+ *  orientation
+ * @return 1 if a result was found, else return 0
+ */
+static int probe_result( struct Search * search, const struct State * state,
+                         struct Transposition * entry )
+{
+    int symmetry;
+    int found = probe_trans_table( search->table, canonical_key( state, &symmetry ), entry );
 
-        beta = min( beta, v );
+    if( found && entry->has_move )
+        transform_move( &entry->move, symmetry );
 
-        current = current->next;
-    }
+    return found;
+}
 
-    /* free list of actions */
-    current_b = a->head;
-    while( current_b != NULL )
+/**
+ * Order moves so the most promising is searched first
+ *
+ * While the search follows the last iteration's principal variation, its
+ * move is the hash move. Otherwise a stored best move is. The other moves
+ * are ordered by ordering.c.
+ *
+ * @param search the running search
+ * @param moves the moves of the node
+ * @param scores set to the ordering score of each move
+ * @param ply the node's distance from the root
+ * @param entry the node's transposition, or null
+ */
+static void order_moves( struct Search * search, const struct MoveList * moves, int scores[],
+                         int ply, const struct Transposition * entry )
+{
+    if( search->follow_pv )
     {
-        Free( current_b->data, sizeof( struct Move ) );
-        current_b = current_b->next;
+        if( ply < search->previous_pv_length &&
+            score_moves( search, moves, ply, &search->previous_pv[ ply ], scores ) )
+            return;
+
+        search->follow_pv = 0;
     }
-    delete_list( &a );
-    return v;
+
+    score_moves( search, moves, ply, ( entry != NULL && entry->has_move ) ? &entry->move : NULL,
+                 scores );
 }
 
 /**
- * Perform a cutoff test
+ * Record a new best move and the line below it
  *
- * @param state the state of the game
- * @param depth the current depth
- * @return 1 if depth has exceeded max depth, or if terminal state has been reached, else return 0
+ * @param search the running search
+ * @param ply the node's distance from the root
+ * @param move the node's new best move
  */
-int cutoff_test( const struct State * state, int depth )
+static void update_pv( struct Search * search, int ply, const struct Move * move )
 {
-    if( depth > MAX_DEPTH )
-        return 1;
-
-    return terminal_test( state );
+    search->pv[ ply ][ 0 ] = *move;
+    for( int i = 0; i < search->pv_length[ ply + 1 ]; i++ )
+        search->pv[ ply ][ i + 1 ] = search->pv[ ply + 1 ][ i ];
+    search->pv_length[ ply ] = search->pv_length[ ply + 1 ] + 1;
 }
 
 /**
- * Alpha beta search with time, memory, and depth cutoff
+ * Check if a node's younger brothers may be shared between threads
  *
- * @param game_state a game tree root
- * @return a move
+ * @param search the running search
+ * @param draft the plies left to search below the node
+ * @param moves the number of moves at the node
+ * @return 1 if the node may split, else return 0
  */
-struct Move * alpha_beta_search( struct GameNode * game_state )
+static int can_split( const struct Search * search, int draft, int moves )
 {
-    int v = max_value( game_state, 0, INT_MIN, INT_MAX );
-
-    //printf( "Best util val: %d\n", game_state->best_util_val );
-    //printf( "Max val : %d\n", v );
-    //printf( "Best move: " );
-    //print_move( game_state->best_move );
-    
-    return game_state->best_move;
+    return search->worker >= 0 && draft >= SPLIT_DRAFT && moves > 1;
 }
 
+/**
+ * Search a task of a split point
+ *
+ * The move is searched with the split point's current window, as a younger
+ * brother in principal variation search. A better value is recorded in the
+ * split point, and a cutoff aborts the threads searching its other moves.
+ *
+ * @param search the search of the current thread
+ * @param task a task to search
+ */
+static void run_task( struct Search * search, const struct Task * task )
+{
+    struct SplitPoint * split = task->split;
+    struct SplitPoint * outer = search->split;
+    int outer_depth = search->depth;
+    int alpha, beta, value;
+
+    if( !split_aborted( split ) )
+    {
+        struct State state = split->state;
+
+        pthread_mutex_lock( &split->lock );
+        alpha = split->alpha;
+        beta = split->beta;
+        pthread_mutex_unlock( &split->lock );
+
+        search->split = split;
+        search->depth = split->depth;
+        search->follow_pv = 0;
+        make_move( &state, &task->move );
+
+        if( split->maximizing )
+        {
+            value = min_value( search, &state, split->ply + 1, alpha, alpha + 1 );
+            if( value > alpha && value < beta && !search->stopped )
+            {
+                pthread_mutex_lock( &split->lock );
+                alpha = split->alpha;
+                beta = split->beta;
+                pthread_mutex_unlock( &split->lock );
+
+                value = min_value( search, &state, split->ply + 1, alpha, beta );
+            }
+        }
+        else
+        {
+            value = max_value( search, &state, split->ply + 1, beta - 1, beta );
+            if( value < beta && value > alpha && !search->stopped )
+            {
+                pthread_mutex_lock( &split->lock );
+                alpha = split->alpha;
+                beta = split->beta;
+                pthread_mutex_unlock( &split->lock );
+
+                value = max_value( search, &state, split->ply + 1, alpha, beta );
+            }
+        }
+
+        if( !search->stopped )
+        {
+            int cutoff = 0;
+
+            pthread_mutex_lock( &split->lock );
+
+            if( split->maximizing ? value > split->v : value < split->v )
+            {
+                split->v = value;
+                split->pv[ 0 ] = task->move;
+                for( int i = 0; i < search->pv_length[ split->ply + 1 ]; i++ )
+                    split->pv[ i + 1 ] = search->pv[ split->ply + 1 ][ i ];
+                split->pv_length = search->pv_length[ split->ply + 1 ] + 1;
+            }
+
+            if( split->maximizing )
+            {
+                cutoff = split->v >= split->beta;
+                split->alpha = max( split->alpha, split->v );
+            }
+            else
+            {
+                cutoff = split->v <= split->alpha;
+                split->beta = min( split->beta, split->v );
+            }
+
+            if( cutoff && !split->aborted )
+            {
+                __atomic_store_n( &split->aborted, 1, __ATOMIC_RELAXED );
+                record_cutoff( search, &task->move, split->ply, split->depth - split->ply );
+            }
+
+            pthread_mutex_unlock( &split->lock );
+        }
+
+        /* the caller finds out for itself whether it must stop */
+        search->stopped = 0;
+        search->split = outer;
+        search->depth = outer_depth;
+    }
+
+    __atomic_fetch_sub( &split->pending, 1, __ATOMIC_ACQ_REL );
+}
+
+/**
+ * Take a task from another thread
+ *
+ * @param search the search of the current thread
+ * @param task set to the task taken
+ * @param within only take a task below this split point, or null for any
+ * @return 1 if a task was taken, else return 0
+ */
+static int steal_task( const struct Search * search, struct Task * task,
+                       const struct SplitPoint * within )
+{
+    for( int i = 1; i < search_threads; i++ )
+    {
+        int victim = ( search->worker + i ) % search_threads;
+        if( steal_deque( deques[ victim ], task, within ) )
+            return 1;
+    }
+
+    return 0;
+}
+
+/**
+ * Search a node's younger brothers in parallel (young brothers wait)
+ *
+ * The eldest brother has been searched. The other moves become tasks on the
+ * current thread's deque, where idle threads may steal them. The current
+ * thread searches its own tasks, then helps with tasks below the node until
+ * every move is finished.
+ *
+ * @param search the running search
+ * @param state the node's state
+ * @param ply the node's distance from the root
+ * @param alpha alpha after the eldest brother
+ * @param beta beta after the eldest brother
+ * @param v the eldest brother's value
+ * @param moves the moves of the node, the first already searched
+ * @param scores the ordering score of each move
+ * @param maximizing 1 if the max player is to move at the node
+ * @return the node's value, its best line is left in search->pv[ ply ]
+ */
+static int split( struct Search * search, const struct State * state, int ply, int alpha,
+                  int beta, int v, struct MoveList * moves, int scores[], int maximizing )
+{
+    struct SplitPoint split;
+    struct Task task;
+    int spins = 0;
+
+    split.parent = search->split;
+    split.state = *state;
+    split.ply = ply;
+    split.depth = search->depth;
+    split.maximizing = maximizing;
+    split.alpha = alpha;
+    split.beta = beta;
+    split.v = v;
+    split.pv_length = search->pv_length[ ply ];
+    for( int i = 0; i < split.pv_length; i++ )
+        split.pv[ i ] = search->pv[ ply ][ i ];
+    split.pending = moves->count - 1;
+    split.aborted = 0;
+    pthread_mutex_init( &split.lock, NULL );
+
+    /* push the least promising first, so the owner pops the best and
+     * thieves take the rest */
+    for( int i = 1; i < moves->count; i++ )
+        pick_move( moves, scores, i );
+
+    task.split = &split;
+    for( int i = moves->count - 1; i > 0; i-- )
+    {
+        task.move = moves->moves[ i ];
+        push_deque( deques[ search->worker ], &task );
+    }
+
+    while( __atomic_load_n( &split.pending, __ATOMIC_ACQUIRE ) > 0 )
+    {
+        if( pop_deque( deques[ search->worker ], &task, &split ) ||
+            steal_task( search, &task, &split ) )
+        {
+            run_task( search, &task );
+            spins = 0;
+        }
+        else if( ++spins < IDLE_SPINS )
+            sched_yield();
+        else
+            nanosleep( &(struct timespec) { 0, 50000 }, NULL );
+    }
+
+    pthread_mutex_lock( &split.lock );
+    v = split.v;
+    search->pv_length[ ply ] = split.pv_length;
+    for( int i = 0; i < split.pv_length; i++ )
+        search->pv[ ply ][ i ] = split.pv[ i ];
+    pthread_mutex_unlock( &split.lock );
+
+    pthread_mutex_destroy( &split.lock );
+
+    /* stop if time ran out or a split point above was cut off */
+    time_is_up( search );
+
+    return v;
+}
+
+/**
+ * Max of alpha beta
+ *
+ * The search walks a single state down and up the tree with make_move()
+ * and unmake_move(), and stores each node's result in the transposition
+ * table. If the search is stopped the value returned is meaningless and
+ * nothing is stored.
+ *
+ * Moves after the first are searched with a null window, as principal
+ * variation search. In a split search they may be shared with other
+ * threads once the first is searched.
+ *
+ * @param search the running search
+ * @param state the current game state, restored before returning
+ * @param ply the distance from the root
+ * @param alpha
+ * @param beta
+ * @return a utility value
+ */
+static int max_value( struct Search * search, struct State * state, int ply, int alpha, int beta )
+{
+    search->nodes++;
+    search->pv_length[ ply ] = 0;
+
+    if( time_is_up( search ) )
+        return eval( state );
+
+    /* an endgame the solver can finish needs no search; near the leaves
+     * only the tablebase is worth asking */
+    int outcome = OUTCOME_UNKNOWN;
+    if( ply > 0 )
+        outcome = ( search->depth - ply >= SOLVE_DRAFT ) ? solve_endgame( state )
+                                                         : probe_endgame( state );
+    if( outcome != OUTCOME_UNKNOWN )
+        return ( outcome == OUTCOME_WIN ) ? SOLVED_SCORE : -SOLVED_SCORE;
+
+    if( cutoff_test( state, search->depth - ply ) )
+        return eval( state );
+
+    struct Transposition entry;
+    int draft = search->depth - ply;
+    int found = probe_result( search, state, &entry );
+
+    /* the root always searches, it needs a move */
+    if( found && ply > 0 && table_cutoff( &entry, draft, alpha, beta ) )
+        return entry.score;
+
+    int alpha_start = alpha;
+    int v = INT_MIN;
+    int min_val;
+    struct Move best;
+
+    struct MoveList a;
+    int scores[ MAX_MOVES ];
+    actions( state, &a ); /* get possible actions */
+    if( ply == 0 )
+        remove_symmetric_moves( state, &a );
+    order_moves( search, &a, scores, ply, found ? &entry : NULL );
+
+    /* iterate over all moves */
+    for( int i = 0; i < a.count; i++ )
+    {
+        pick_move( &a, scores, i );
+        struct Move * current = &a.moves[ i ];
+
+        /* find max value */
+        struct Undo undo = make_move( state, current );
+        if( i == 0 )
+            min_val = min_value( search, state, ply + 1, alpha, beta );
+        else
+        {
+            /* expect the move to be no better than alpha, and search it
+             * again with the full window only if it is */
+            min_val = min_value( search, state, ply + 1, alpha, alpha + 1 );
+            if( min_val > alpha && min_val < beta && !search->stopped )
+                min_val = min_value( search, state, ply + 1, alpha, beta );
+        }
+        unmake_move( state, current, undo );
+
+        /* only the first move can be on the last principal variation */
+        search->follow_pv = 0;
+
+        if( search->stopped )
+            return 0;
+
+        if( min_val > v )
+        {
+            best = *current;
+            update_pv( search, ply, current );
+        }
+
+        v = max( v, min_val );
+
+        if( v >= beta )
+        {
+            record_cutoff( search, current, ply, draft );
+            break;
+        }
+
+        alpha = max( alpha, v );
+
+        /* the eldest brother is searched, the younger ones may be shared */
+        if( i == 0 && can_split( search, draft, a.count ) )
+        {
+            v = split( search, state, ply, alpha, beta, v, &a, scores, 1 );
+            if( search->stopped )
+                return 0;
+
+            best = search->pv[ ply ][ 0 ];
+            break;
+        }
+    }
+
+    store_result( search, state, draft, v, alpha_start, beta, &best, 1 );
+    return v;
+}
+
+/**
+ * Min of alpha beta
+ *
+ * @param search the running search
+ * @param state the current game state, restored before returning
+ * @param ply the distance from the root
+ * @param alpha
+ * @param beta
+ * @return a utility value
+ */
+static int min_value( struct Search * search, struct State * state, int ply, int alpha, int beta )
+{
+    search->nodes++;
+    search->pv_length[ ply ] = 0;
+
+    /* eval() scores for the player to move, here the min player */
+    if( time_is_up( search ) )
+        return -eval( state );
+
+    int outcome = ( search->depth - ply >= SOLVE_DRAFT ) ? solve_endgame( state )
+                                                         : probe_endgame( state );
+    if( outcome != OUTCOME_UNKNOWN )
+        return ( outcome == OUTCOME_WIN ) ? -SOLVED_SCORE : SOLVED_SCORE;
+
+    if( cutoff_test( state, search->depth - ply ) )
+        return -eval( state );
+
+    struct Transposition entry;
+    int draft = search->depth - ply;
+    int found = probe_result( search, state, &entry );
+
+    if( found )
+    {
+        flip_view( &entry );
+        if( table_cutoff( &entry, draft, alpha, beta ) )
+            return entry.score;
+    }
+
+    int beta_start = beta;
+    int v = INT_MAX;
+    int max_val;
+    struct Move best;
+
+    struct MoveList a;
+    int scores[ MAX_MOVES ];
+    actions( state, &a ); /* get possible actions */
+    order_moves( search, &a, scores, ply, found ? &entry : NULL );
+
+    /* iterate over all actions */
+    for( int i = 0; i < a.count; i++ )
+    {
+        pick_move( &a, scores, i );
+        struct Move * current = &a.moves[ i ];
+
+        struct Undo undo = make_move( state, current );
+        if( i == 0 )
+            max_val = max_value( search, state, ply + 1, alpha, beta );
+        else
+        {
+            max_val = max_value( search, state, ply + 1, beta - 1, beta );
+            if( max_val < beta && max_val > alpha && !search->stopped )
+                max_val = max_value( search, state, ply + 1, alpha, beta );
+        }
+        unmake_move( state, current, undo );
+
+        search->follow_pv = 0;
+
+        if( search->stopped )
+            return 0;
+
+        if( max_val < v )
+        {
+            best = *current;
+            update_pv( search, ply, current );
+        }
+
+        v = min( v, max_val );
+
+        if( v <= alpha )
+        {
+            record_cutoff( search, current, ply, draft );
+            break;
+        }
+
+        beta = min( beta, v );
+
+        /* the eldest brother is searched, the younger ones may be shared */
+        if( i == 0 && can_split( search, draft, a.count ) )
+        {
+            v = split( search, state, ply, alpha, beta, v, &a, scores, 0 );
+            if( search->stopped )
+                return 0;
+
+            best = search->pv[ ply ][ 0 ];
+            break;
+        }
+    }
+
+    store_result( search, state, draft, v, alpha, beta_start, &best, 0 );
+    return v;
+}
+
+/**
+ * Perform a cutoff test
+ *
+ * @param state the state of the game
+ * @param depth the plies left to search
+ * @return 1 if no plies are left, or if terminal state has been reached, else return 0
+ */
+int cutoff_test( const struct State * state, int depth )
+{
+    if( depth <= 0 )
+        return 1;
+
+    return terminal_test( state );
+}
+
+/**
+ * Set the size of the transposition table, discarding its contents
+ *
+ * The table is made by the next search, so a size never searched takes no
+ * memory.
+ *
+ * @param megabytes the most memory the table may use
+ */
+void set_trans_table_size( size_t megabytes )
+{
+    if( trans_table != NULL )
+        delete_trans_table( &trans_table );
+
+    trans_table_mb = megabytes;
+}
+
+/**
+ * Set the number of threads searching each move
+ *
+ * @param threads the number of threads, at least 1
+ */
+void set_search_threads( int threads )
+{
+    search_threads = ( threads < 1 ) ? 1 : threads;
+}
+
+/**
+ * Play with a game clock instead of a fixed time per move
+ *
+ * @param time the time for all of the moves of each player the computer plays
+ * @param increment time added to the clock after each move
+ */
+void set_game_clock( millis time, millis increment )
+{
+    init_time_manager( &time_managers[ 0 ], 1, time, increment );
+    init_time_manager( &time_managers[ 1 ], 1, time, increment );
+}
+
+/**
+ * Think for a fixed time about each move, without a game clock
+ *
+ * @param time the time for each move
+ */
+void set_move_time( millis time )
+{
+    init_time_manager( &time_managers[ 0 ], 0, time, 0 );
+    init_time_manager( &time_managers[ 1 ], 0, time, 0 );
+}
+
+/**
+ * Limit the nodes of each search
+ *
+ * The threads of a search share the limit, each stopping the search when
+ * it has visited its part.
+ *
+ * @param nodes the most nodes to visit, 0 for no limit
+ */
+void set_search_nodes( unsigned long nodes )
+{
+    node_limit = nodes;
+}
+
+/**
+ * Stop the running search from another thread
+ *
+ * The search returns the best move of its last completed iteration. The
+ * request stays until it is withdrawn, so a search started before then
+ * stops at once.
+ *
+ * @param stop 1 to stop, 0 to let searches run
+ */
+void set_search_stop( int stop )
+{
+    __atomic_store_n( &stop_requested, stop, __ATOMIC_RELAXED );
+}
+
+/**
+ * Follow the iterations of each search
+ *
+ * Iterations a search takes over from an earlier one are reported first,
+ * with no nodes, so every search reports at least once.
+ *
+ * @param report called with the root after each completed iteration, its
+ *  nodes those visited so far, or null
+ */
+void set_search_report( void ( * report )( const struct GameNode * game_state ) )
+{
+    iteration_report = report;
+}
+
+/**
+ * Forget what the searches of an earlier game learned
+ *
+ * The transposition table, the history, the iterations kept for the
+ * expected states and the endgame solver's memo are cleared, so a game
+ * does not start from what the game before it learned. The clocks are
+ * left as they are.
+ */
+void reset_search( void )
+{
+    if( trans_table != NULL )
+        clear_trans_table( trans_table );
+
+    memset( learned_history, 0, sizeof( learned_history ) );
+    expected_valid[ 0 ] = 0;
+    expected_valid[ 1 ] = 0;
+    clear_endgame();
+}
+
+/**
+ * Choose how the threads of a search work together
+ *
+ * @param split 1 to split the tree between the threads (young brothers
+ *  wait), 0 to have them share only the transposition table (lazy SMP)
+ */
+void set_search_split( int split )
+{
+    search_split = split;
+}
+
+/**
+ * Set the deepest iteration of each search
+ *
+ * @param depth the most plies to search, from 1 to MAX_DEPTH
+ */
+void set_search_depth( int depth )
+{
+    search_depth = ( depth < 1 ) ? 1 : ( depth > MAX_DEPTH ) ? MAX_DEPTH : depth;
+}
+
+/**
+ * Prepare a search
+ *
+ * @param search a search to set up
+ * @param stop_all the flag shared by the threads of the search
+ * @param deadline when the search must stop, from clock_ms()
+ */
+static void init_search( struct Search * search, int * stop_all, millis deadline )
+{
+    search->table = trans_table;
+    search->stopped = 0;
+    search->stop_all = stop_all;
+    search->deadline = deadline;
+    search->nodes = 0;
+    search->previous_pv_length = 0;
+    search->worker = -1;
+    search->split = NULL;
+    search->pondering = 0;
+    clear_ordering( search );
+
+    /* the killers belong to the plies of the last root, the history does not */
+    memcpy( search->history, learned_history, sizeof( learned_history ) );
+}
+
+/**
+ * Search the root to a depth
+ *
+ * The search starts with an aspiration window around the last iteration's
+ * score, widened when the score falls outside it. A completed iteration's
+ * principal variation is searched first by the next.
+ *
+ * @param search the running search
+ * @param state the root state, restored before returning
+ * @param depth the plies to search
+ * @param last the score of the last iteration, if depth > 1
+ * @return the root's value, meaningless if the search stopped
+ */
+static int search_root( struct Search * search, struct State * state, int depth, int last )
+{
+    int delta = ASPIRATION_WINDOW;
+    int alpha = INT_MIN;
+    int beta = INT_MAX;
+    int v;
+
+    /* expect the score to be close to the last iteration's */
+    if( depth > 1 )
+    {
+        alpha = last - delta;
+        beta = last + delta;
+    }
+
+    search->depth = depth;
+
+    for( ;; )
+    {
+        search->follow_pv = 1;
+        v = max_value( search, state, 0, alpha, beta );
+
+        if( search->stopped )
+            return v;
+
+        if( v > alpha && v < beta )
+            break;
+
+        /* widen the side that failed, until it is open */
+        delta *= 4;
+        if( v <= alpha )
+            alpha = ( delta > ASPIRATION_LIMIT ) ? INT_MIN : v - delta;
+        else
+            beta = ( delta > ASPIRATION_LIMIT ) ? INT_MAX : v + delta;
+    }
+
+    for( int i = 0; i < search->pv_length[ 0 ]; i++ )
+        search->previous_pv[ i ] = search->pv[ 0 ][ i ];
+    search->previous_pv_length = search->pv_length[ 0 ];
+
+    return v;
+}
+
+/**
+ * Run a helper thread of a search
+ *
+ * Helpers search the same root as the main thread, only to fill the shared
+ * transposition table. Every other helper starts one ply deeper, so the
+ * threads spread over more than one depth.
+ *
+ * @param arg the helper
+ * @return null
+ */
+static void * helper_search( void * arg )
+{
+    struct Helper * helper = arg;
+    int pieces = popcount( bb_or( helper->state.black, helper->state.white ) );
+    int v = 0;
+
+    for( int depth = 1 + helper->id % 2; depth <= search_depth; depth++ )
+    {
+        v = search_root( &helper->search, &helper->state, depth, v );
+
+        if( helper->search.stopped || depth >= pieces )
+            break;
+    }
+
+    return NULL;
+}
+
+/**
+ * Run a worker thread of a split search
+ *
+ * Workers steal tasks from the other threads until the search stops.
+ *
+ * @param arg the helper
+ * @return null
+ */
+static void * split_worker( void * arg )
+{
+    struct Helper * helper = arg;
+    struct Task task;
+    int spins = 0;
+
+    while( !__atomic_load_n( helper->search.stop_all, __ATOMIC_RELAXED ) )
+    {
+        if( steal_task( &helper->search, &task, NULL ) )
+        {
+            run_task( &helper->search, &task );
+            spins = 0;
+        }
+        else if( ++spins < IDLE_SPINS )
+            sched_yield();
+        else
+            nanosleep( &(struct timespec) { 0, 50000 }, NULL );
+    }
+
+    return NULL;
+}
+
+/**
+ * Run an iterative deepening search of a root
+ *
+ * Iterations the root already holds are not searched again. With more than
+ * one search thread, helper threads search the same root at the same time
+ * and share the transposition table (lazy SMP). Only the main thread's
+ * result is used; the helpers are stopped when it finishes. In a split
+ * search the helpers instead steal the younger brothers of the main
+ * thread's nodes, and of each other's.
+ *
+ * @param game_state the root, set to the last completed iteration
+ * @param deadline when the search must stop, from clock_ms()
+ * @param time_manager decides whether to start another iteration, or null
+ *  to iterate until stopped
+ * @param pondering 1 to stop when input arrives on stdin
+ */
+static void iterative_deepening( struct GameNode * game_state, millis deadline,
+                                 struct TimeManager * time_manager, int pondering )
+{
+    struct Search search;
+    struct State state = *game_state->state;
+    int pieces = popcount( bb_or( state.black, state.white ) );
+    int stop_all = 0;
+    int stable = 0;
+
+    /* a table that does not fit in the memory left is halved until it does */
+    while( trans_table == NULL && trans_table_mb > 0 )
+    {
+        trans_table = new_trans_table( trans_table_mb );
+        if( trans_table == NULL )
+            trans_table_mb /= 2;
+    }
+    if( trans_table == NULL )
+    {
+        printf( "out of memory for the transposition table\n" );
+        exit( EXIT_FAILURE );
+    }
+
+    init_search( &search, &stop_all, deadline );
+    search.pondering = pondering;
+
+    /* follow the line of the iterations already done */
+    search.pv_length[ 0 ] = 0;
+    search.previous_pv_length = game_state->pv_length;
+    for( int i = 0; i < game_state->pv_length; i++ )
+        search.previous_pv[ i ] = game_state->pv[ i ];
+
+    /* start the helpers */
+    int helpers = search_threads - 1;
+    struct Helper * helper = Calloc( helpers + 1, sizeof( struct Helper ) );
+    if( helper == NULL )
+        helpers = 0;
+
+    if( search_split && helpers > 0 )
+    {
+        int made = 0;
+
+        deques = Calloc( search_threads, sizeof( struct Deque * ) );
+        if( deques != NULL )
+            while( made < search_threads && ( deques[ made ] = new_deque( MAX_PLY * MAX_MOVES ) ) != NULL )
+                made++;
+
+        /* without room for every deque, the helpers share the table only */
+        if( deques != NULL && made < search_threads )
+        {
+            for( int i = 0; i < made; i++ )
+                delete_deque( &deques[ i ] );
+            Free( deques );
+            deques = NULL;
+        }
+        else if( deques != NULL )
+            search.worker = 0;
+    }
+
+    for( int i = 0; i < helpers; i++ )
+    {
+        helper[ i ].id = i + 1;
+        helper[ i ].state = state;
+        init_search( &helper[ i ].search, &stop_all, deadline );
+
+        if( deques != NULL )
+        {
+            helper[ i ].search.worker = i + 1;
+            pthread_create( &helper[ i ].thread, NULL, split_worker, &helper[ i ] );
+        }
+        else
+            pthread_create( &helper[ i ].thread, NULL, helper_search, &helper[ i ] );
+    }
+
+    /* report the iterations taken over as the first one */
+    if( iteration_report != NULL && game_state->depth > 0 )
+    {
+        game_state->nodes = 0;
+        iteration_report( game_state );
+    }
+
+    /* every move captures, so no line is longer than the pieces left */
+    for( int depth = game_state->depth + 1; depth <= search_depth && depth <= pieces; depth++ )
+    {
+        int last = game_state->best_util_val;
+        int v = search_root( &search, &state, depth, last );
+
+        if( search.stopped )
+            break;
+
+        if( depth > 1 && game_state->pv_length > 0 && search.pv_length[ 0 ] > 0 &&
+            compare_move( &game_state->pv[ 0 ], &search.pv[ 0 ][ 0 ] ) )
+            stable++;
+        else
+            stable = 0;
+
+        /* save the completed iteration */
+        game_state->best_util_val = v;
+        game_state->depth = depth;
+        game_state->pv_length = search.pv_length[ 0 ];
+        for( int i = 0; i < search.pv_length[ 0 ]; i++ )
+            game_state->pv[ i ] = search.pv[ 0 ][ i ];
+
+        if( iteration_report != NULL )
+        {
+            game_state->nodes = search.nodes;
+            for( int i = 0; i < helpers; i++ )
+                game_state->nodes += __atomic_load_n( &helper[ i ].search.nodes, __ATOMIC_RELAXED );
+            iteration_report( game_state );
+        }
+
+        /* a forced move or a solved root needs no more thought */
+        if( count_moves( &state ) == 1 || v >= SOLVED_SCORE || v <= -SOLVED_SCORE )
+            break;
+
+        if( time_manager != NULL &&
+            !continue_search( time_manager, stable, depth > 1 ? last - v : 0 ) )
+            break;
+    }
+
+    __atomic_store_n( &stop_all, 1, __ATOMIC_RELAXED );
+    game_state->nodes = search.nodes;
+    for( int i = 0; i < helpers; i++ )
+    {
+        pthread_join( helper[ i ].thread, NULL );
+        game_state->nodes += helper[ i ].search.nodes;
+    }
+    Free( helper );
+
+    /* pass the history on, counting for less than what the next search learns */
+    age_history( &search );
+    memcpy( learned_history, search.history, sizeof( learned_history ) );
+
+    if( deques != NULL )
+    {
+        for( int i = 0; i < search_threads; i++ )
+            delete_deque( &deques[ i ] );
+        Free( deques );
+        deques = NULL;
+    }
+
+    /* if no iteration left a move, take the best move found so far, or
+     * else any move */
+    if( game_state->pv_length == 0 )
+    {
+        struct MoveList moves;
+
+        if( search.pv_length[ 0 ] > 0 )
+            game_state->pv[ 0 ] = search.pv[ 0 ][ 0 ];
+        else if( actions( &state, &moves ) > 0 )
+            game_state->pv[ 0 ] = moves.moves[ 0 ];
+        else
+            return;
+
+        game_state->pv_length = 1;
+    }
+}
+
+/**
+ * Remember a search's iterations for the state its principal variation
+ * leads to
+ *
+ * If the game follows the line, the state is searched next with the
+ * remembered iterations already done. The line's moves at the state are
+ * exactly as deep as the rest of the line was searched. A line cut short
+ * at or before the state, by the table or the endgame solver, leaves no
+ * move to start from and is not remembered.
+ *
+ * @param node a searched node
+ * @param state the node's state
+ * @param plies the moves of the principal variation that lead to the state
+ */
+static void expect_state( const struct GameNode * node, const struct State * state, int plies )
+{
+    struct State expected = *state;
+    int player = ( state->player == 'W' );
+    struct GameNode * expected_node = &expected_nodes[ player ];
+
+    expected_valid[ player ] = 0;
+    if( node->depth <= plies || node->pv_length <= plies )
+        return;
+
+    for( int i = 0; i < plies; i++ )
+        make_move( &expected, &node->pv[ i ] );
+
+    expected_node->depth = node->depth - plies;
+    expected_node->best_util_val = node->best_util_val;
+    expected_node->pv_length = node->pv_length - plies;
+    for( int i = 0; i < expected_node->pv_length; i++ )
+        expected_node->pv[ i ] = node->pv[ i + plies ];
+
+    expected_keys[ player ] = state_key( &expected );
+    expected_valid[ player ] = 1;
+}
+
+/**
+ * Carry on from the remembered iterations, if they are of a node's state
+ *
+ * Iterations deeper than the depth limit are not taken over, so a search
+ * limited to a depth always ends at that depth.
+ *
+ * @param node a node about to be searched
+ * @param state the node's state
+ */
+static void resume_expected( struct GameNode * node, const struct State * state )
+{
+    int player = ( state->player == 'W' );
+    const struct GameNode * expected_node = &expected_nodes[ player ];
+
+    if( !expected_valid[ player ] || expected_keys[ player ] != state_key( state ) ||
+        expected_node->depth > search_depth )
+        return;
+
+    node->depth = expected_node->depth;
+    node->best_util_val = expected_node->best_util_val;
+    node->pv_length = expected_node->pv_length;
+    for( int i = 0; i < expected_node->pv_length; i++ )
+        node->pv[ i ] = expected_node->pv[ i ];
+}
+
+/**
+ * Search while the opponent thinks
+ *
+ * With a predicted reply, the state after it is searched for the computer
+ * player, and the result is kept for alpha_beta_search() in case the reply
+ * is played. Without one, the state itself is searched, which fills the
+ * transposition table for every reply. The search runs until input arrives
+ * on stdin, or until it has searched as deep as it can.
+ *
+ * @param state the state the opponent moves from
+ * @param predicted the opponent's expected move, or null
+ */
+void ponder_search( const struct State * state, const struct Move * predicted )
+{
+    struct State root = *state;
+    struct GameNode node = { 0 };
+
+    if( predicted != NULL && !validate_action( state, predicted ) )
+        predicted = NULL;
+    if( predicted != NULL )
+    {
+        make_move( &root, predicted );
+        resume_expected( &node, &root );
+    }
+
+    node.state = &root;
+    iterative_deepening( &node, LLONG_MAX, NULL, 1 );
+
+    if( predicted != NULL )
+        expect_state( &node, &root, 0 );
+}
+
+/**
+ * Search a root without a time limit
+ *
+ * The search runs until set_search_stop() stops it, or until it has
+ * searched as deep as the depth and node limits allow. Like a ponder
+ * search, it keeps its iterations, and a timed search of the same state
+ * carries on from them.
+ *
+ * @param game_state a game tree root
+ * @return a move, or null if there is no move
+ */
+struct Move * infinite_search( struct GameNode * game_state )
+{
+    if( trans_table != NULL )
+        age_trans_table( trans_table );
+
+    game_state->depth = 0;
+    game_state->pv_length = 0;
+    resume_expected( game_state, game_state->state );
+
+    iterative_deepening( game_state, LLONG_MAX, NULL, 0 );
+    expect_state( game_state, game_state->state, 0 );
+
+    if( game_state->best_move != NULL )
+        Free( game_state->best_move );
+    game_state->best_move = NULL;
+
+    if( game_state->pv_length > 0 )
+        game_state->best_move = clone_move( &game_state->pv[ 0 ] );
+
+    return game_state->best_move;
+}
+
+/**
+ * Iterative deepening alpha beta search with time and depth cutoff
+ *
+ * The root is searched to depth 1, 2, 3 and so on. Each completed iteration
+ * saves its best move and principal variation in the root. The time manager
+ * decides whether to start another iteration, and when to stop the search;
+ * the unfinished iteration is then discarded. If the last move's search, or
+ * the ponder search, expected the root, the search carries on from the
+ * iterations it already did below the root.
+ *
+ * @param game_state a game tree root
+ * @return a move, or null if there is no move
+ */
+struct Move * alpha_beta_search( struct GameNode * game_state )
+{
+    struct TimeManager * time_manager = &time_managers[ game_state->state->player == 'W' ];
+
+    start_move( time_manager, game_state->state );
+
+    /* what earlier moves stored stays, but gives way to this move's search */
+    if( trans_table != NULL )
+        age_trans_table( trans_table );
+
+    /* take over the iterations searched by the last move, or while pondering */
+    game_state->depth = 0;
+    game_state->pv_length = 0;
+    resume_expected( game_state, game_state->state );
+
+    iterative_deepening( game_state, move_deadline( time_manager ), time_manager, 0 );
+
+    /* the search after the expected reply starts two plies down this one */
+    expect_state( game_state, game_state->state, 2 );
+
+    if( game_state->best_move != NULL )
+        Free( game_state->best_move );
+    game_state->best_move = NULL;
+
+    if( game_state->pv_length > 0 )
+        game_state->best_move = clone_move( &game_state->pv[ 0 ] );
+
+    end_move( time_manager );
+
+    return game_state->best_move;
+}
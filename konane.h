@@ -5,23 +5,101 @@
 #ifndef _KONANE_H_
 #define _KONANE_H_
 
+#include <stddef.h>
+#include <stdint.h>
+#include <pthread.h>
+
 #include "state.h"
 #include "move.h"
 #include "list.h"
 #include "game_node.h"
+#include "trans_table.h"
+#include "clock.h"
+
+/** what is needed to take back a move */
+struct Undo {
+    bitboard captured;              /**< squares of the pieces the move captured */
+    uint64_t hash[ SYMMETRIES ];    /**< zobrist keys of the pieces before the move */
+};
+
+/** a node whose younger brothers are shared between threads */
+struct SplitPoint {
+    struct SplitPoint * parent;     /**< split point the node was reached from, or null */
+    struct State state;             /**< state at the node */
+    int ply;                        /**< distance from the root */
+    int depth;                      /**< plies the search reaches below the root */
+    int maximizing;                 /**< 1 if the max player is to move */
+    int alpha;                      /**< current alpha, raised by finished moves */
+    int beta;                       /**< current beta, lowered by finished moves */
+    int v;                          /**< value of the best move so far */
+    struct Move pv[ MAX_PLY ];      /**< best line found from the node */
+    int pv_length;                  /**< moves in pv */
+    int pending;                    /**< moves not yet finished */
+    int aborted;                    /**< set on a cutoff, the other moves are not needed */
+    pthread_mutex_t lock;           /**< guards the fields above */
+};
+
+/** state of one search thread */
+struct Search {
+    int depth;                              /**< plies to search below the root */
+    int stopped;                            /**< set when the search must unwind */
+    int * stop_all;                         /**< shared by the threads, set to stop them all */
+    millis deadline;                        /**< clock_ms() time to stop at */
+    int pondering;                          /**< 1 to stop when input arrives on stdin */
+    int worker;                             /**< thread number in a split search, else -1 */
+    struct SplitPoint * split;              /**< split point of the move being searched, or null */
+    unsigned long nodes;                    /**< nodes visited */
+    struct TransTable * table;              /**< transposition table */
+    struct Move pv[ MAX_PLY ][ MAX_PLY ];   /**< pv[ ply ] is the best line found from ply */
+    int pv_length[ MAX_PLY ];               /**< moves in each line of pv */
+    struct Move previous_pv[ MAX_PLY ];     /**< principal variation of the last iteration */
+    int previous_pv_length;                 /**< moves in previous_pv */
+    int follow_pv;                          /**< 1 while on the path of previous_pv */
+    struct Move killers[ MAX_PLY ][ 2 ];    /**< recent cutoff moves of each ply */
+    int history[ SIZE * SIZE ][ SIZE * SIZE ];  /**< cutoff score by start and end square */
+};
 
-struct List * actions( const struct State * state );
+int actions( const struct State * state, struct MoveList * moves );
 struct State * result( const struct State * state, const struct Move * action );
+struct Undo make_move( struct State * state, const struct Move * action );
+void unmake_move( struct State * state, const struct Move * action, struct Undo undo );
 int validate_action( const struct State * state, const struct Move * action );
+int has_moves( const struct State * state );
+int count_moves( const struct State * state );
 int terminal_test( const struct State * state );
 char opposite_player( char player );
 
+/** rows and columns of the squares the game opens on */
+#define CENTER_LOW ( SIZE / 2 - 1 )     /**< top left of the four center squares */
+#define CENTER_HIGH ( SIZE / 2 )        /**< bottom right of the four center squares */
+#define EDGE ( SIZE - 1 )               /**< last row and column */
+
 int validate_first_in_move( const struct State * state, const struct Move * action );
 int validate_second_in_move( const struct State * state, const struct Move * action );
 
+/** most removals open to a player, the centre squares and the corners */
+#define MAX_REMOVALS 8
+
+int removals( const struct State * state, struct Move moves[] );
+
 int cutoff_test( const struct State * state, int depth );
 int eval( struct State * state );
 
+/** default size of the transposition table, in megabytes */
+#define TRANS_TABLE_MB 16
+
+void set_trans_table_size( size_t megabytes );
+void set_search_threads( int threads );
+void set_search_depth( int depth );
+void set_search_split( int split );
+void set_game_clock( millis time, millis increment );
+void set_move_time( millis time );
+void set_search_nodes( unsigned long nodes );
+void set_search_stop( int stop );
+void set_search_report( void ( * report )( const struct GameNode * game_state ) );
+void reset_search( void );
 struct Move * alpha_beta_search( struct GameNode * game_state );
+struct Move * infinite_search( struct GameNode * game_state );
+void ponder_search( const struct State * state, const struct Move * predicted );
 
 #endif /* _KONANE_H_ */
@@ -13,15 +13,26 @@
 /**
  * Create a new list
  *
+ * A list in an arena is given back with the arena, not by delete_list().
+ *
+ * @param arena an arena to allocate the list and its nodes from, or null
+ *  for the heap
  * @return a new empty list
  */
-struct List * new_list( void )
+struct List * new_list( struct Arena * arena )
 {
-  struct List * list = Calloc( 1, sizeof( struct List ) );
+  struct List * list;
+
+  if( arena != NULL )
+    list = arena_alloc( arena, sizeof( struct List ) );
+  else
+    list = Calloc( 1, sizeof( struct List ) );
+  assert( list );
 
   list->head = NULL;
   list->tail = NULL;
   list->count = 0;
+  list->arena = arena;
 
   return list;
 }
@@ -35,16 +46,18 @@ void delete_list( struct List ** list )
 {
   struct ListNode * current, * temp;
 
+  assert( (*list)->arena == NULL );
+
   current = (*list)->head;
   while( current != NULL )
     {
       temp = current;
       current = current->next;
 
-      Free( temp, sizeof( struct ListNode ) );
+      Free( temp );
     }
 
-  Free( (*list ), sizeof( struct List ) );
+  Free( (*list ) );
   *list = NULL;
 }
 
@@ -56,7 +69,12 @@ void delete_list( struct List ** list )
  */
 void add_front( struct List ** list, void * data )
 {
-  struct ListNode * node = Calloc( 1, sizeof( struct ListNode ) );
+  struct ListNode * node;
+
+  if( (*list)->arena != NULL )
+    node = arena_alloc( (*list)->arena, sizeof( struct ListNode ) );
+  else
+    node = Calloc( 1, sizeof( struct ListNode ) );
   assert( node );
 
   node->data = data;
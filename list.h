@@ -7,11 +7,14 @@
 #ifndef _LIST_H_
 #define _LIST_H_
 
+#include "arena.h"
+
 /** a linked list */
 struct List {
   struct ListNode * head; /**< pointer to head */
   struct ListNode * tail; /**< pointer to tail */
   int count;              /**< number of items in list */
+  struct Arena * arena;   /**< arena the list lives in, or null for the heap */
 };
 
 /** a linked list node */
@@ -20,7 +23,7 @@ struct ListNode {
   struct ListNode * next; /**< next node */
 };
 
-struct List * new_list( void );
+struct List * new_list( struct Arena * arena );
 void delete_list( struct List ** list );
 
 void add_front( struct List ** list, void * data );
@@ -1,25 +1,155 @@
 /**
- * @brief Play a game of konane
+ * @brief Play a game of konane, or speak the engine protocol
  * @author Eric Watkins, Julian Martinez del Campo, Michael Hnatiw
+ *
+ * The game runs the build of play.c for the size of the board file. With
+ * -e, every size's engine is set up from the options, and each command
+ * line goes to the engine of the board size being played.
  */
+#define _POSIX_C_SOURCE 200809L
+
 #include <stdio.h>
 #include <stdlib.h>
-#include "game.h"
+#include <string.h>
+#include <unistd.h>
 
-int main( int argc, char * argv[] )
+#include "sizes.h"
+
+#define LINE_SIZE 4096      /* longest command */
+#define SEPARATORS " \t\r\n"
+
+#define DECLARE( n ) \
+    int size##n##_main( int argc, char * argv[] ); \
+    int size##n##_configure( int argc, char * argv[], int * protocol ); \
+    void size##n##_engine_open( void ); \
+    int size##n##_engine_command( char * line ); \
+    void size##n##_engine_close( void );
+BOARD_SIZES( DECLARE )
+
+/**
+ * Find the board size a command plays on
+ *
+ * @param line a command
+ * @param size the size of the commands before
+ * @return the size of a newgame <size> or position board command, else
+ * return size
+ */
+static int command_size( const char * line, int size )
+{
+    char copy[ LINE_SIZE ];
+    char * save = NULL;
+
+    strcpy( copy, line );
+    char * command = strtok_r( copy, SEPARATORS, &save );
+    char * word = strtok_r( NULL, SEPARATORS, &save );
+
+    if( command == NULL || word == NULL )
+        return size;
+
+    if( strcmp( command, "newgame" ) == 0 )
+        return atoi( word );
+
+    if( strcmp( command, "position" ) == 0 && strcmp( word, "board" ) == 0 )
+    {
+        char * rows = strtok_r( NULL, SEPARATORS, &save );
+
+        if( rows == NULL )
+            return size;
+
+        size = 1;
+        for( ; *rows != '\0'; rows++ )
+            size += ( *rows == '/' );
+    }
+
+    return size;
+}
+
+/**
+ * Pass a command to the engine of a board size
+ *
+ * @param size a board size
+ * @param line the command
+ * @return 0 after quit, else return 1
+ */
+static int command( int size, char * line )
 {
-    if( argc != 3 )
+#define COMMAND( n ) if( size == n ) return size##n##_engine_command( line );
+    BOARD_SIZES( COMMAND )
+
+    return 1;
+}
+
+/**
+ * Speak the engine protocol on stdin and stdout until quit, or the end of
+ * stdin
+ *
+ * @param argc the number of arguments
+ * @param argv the options, without input file and player color
+ * @return EXIT_SUCCESS, or EXIT_FAILURE if the options are wrong
+ */
+static int engine( int argc, char * argv[] )
+{
+    char line[ LINE_SIZE ];
+    char stop[] = "stop";
+    int size = DEFAULT_SIZE;
+    int protocol, first;
+
+#define OPEN( n ) \
+    optind = 1; \
+    first = size##n##_configure( argc, argv, &protocol ); \
+    if( first < 0 ) \
+        return EXIT_FAILURE; \
+    if( first != argc ) \
+    { \
+        printf( "%s usage: -e takes options only\n", argv[ 0 ] ); \
+        return EXIT_FAILURE; \
+    }
+    BOARD_SIZES( OPEN )
+
+#define START( n ) size##n##_engine_open();
+    BOARD_SIZES( START )
+
+    while( fgets( line, sizeof( line ), stdin ) != NULL )
     {
-        printf( "%s usage: <input file> <player color>\n", argv[ 0 ] );
-        printf( "   input file - a text file consisting of a konane board\n" );
-        printf( "   player color - a single character B, W which indicates the \n" );
-        printf( "       role the agent assumes. If player color is not equal \n" );
-        printf( "       to b or w, then game enters interactive mode\n" );
-        return EXIT_FAILURE;
+        int wanted = command_size( line, size );
+
+        /* the engine left keeps its tables for when its size comes back */
+        if( wanted != size )
+        {
+#define BUILT( n ) || wanted == n
+            if( !( 0 BOARD_SIZES( BUILT ) ) )
+            {
+                printf( "info string no engine for %dx%d boards\n", wanted, wanted );
+                fflush( stdout );
+                continue;
+            }
+
+            command( size, stop );
+            size = wanted;
+        }
+
+        if( !command( size, line ) )
+            break;
     }
 
-    char * str = argv[ 2 ];
-    game( argv[ 1 ], str[ 0 ] );
-    
-  return EXIT_SUCCESS;
+#define CLOSE( n ) size##n##_engine_close();
+    BOARD_SIZES( CLOSE )
+
+    return EXIT_SUCCESS;
+}
+
+int main( int argc, char * argv[] )
+{
+    for( int i = 1; i < argc && strcmp( argv[ i ], "--" ) != 0; i++ )
+        if( strcmp( argv[ i ], "-e" ) == 0 )
+            return engine( argc, argv );
+
+    int size = find_board_size( argc, argv );
+
+#define RUN( n ) if( size == n ) return size##n##_main( argc, argv );
+    BOARD_SIZES( RUN )
+
+#define NAME( n ) " " #n "x" #n
+    printf( "%s: no build for %dx%d boards, only for" BOARD_SIZES( NAME ) "\n", argv[ 0 ], size, size );
+    return EXIT_FAILURE;
 }
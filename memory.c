@@ -0,0 +1,93 @@
+/**
+ * @file memory.c
+ * @brief this file implements memory.h
+ * @author Eric Watkins, Julian Martinez del Campo, Michael Hnatiw
+ */
+#include <stdlib.h>
+#include "memory.h"
+
+static unsigned long _memory_usage = 0;
+static unsigned long _memory_limit = MEMORYSIZE * 1024UL * 1024UL;
+
+/** header before each block from Calloc(), aligned for any type */
+union BlockHeader {
+  size_t size;            /**< bytes in the block */
+  long double align_float;
+  long long align_int;
+  void * align_pointer;
+};
+
+/**
+ * Set the most memory Calloc() may hand out
+ *
+ * @param bytes the memory limit, in bytes
+ */
+void set_memory_limit( unsigned long bytes )
+{
+  __atomic_store_n( &_memory_limit, bytes, __ATOMIC_RELAXED );
+}
+
+/**
+ * Calloc
+ *
+ * This funciton is a wrapper to calloc. It checks that memory was
+ *  properly allocated, and tracks memory usage. Each block starts with a
+ *  header holding its size, so Free() knows exactly what it releases. The
+ *  usage counter is updated atomically, so search threads may allocate
+ *
+ * @param the number of elements in the array
+ * @param size the size of the element
+ * @return a pointer to the allocated memory, or null if it would pass the
+ *  memory limit
+ */
+void * Calloc( size_t nmemb, size_t size )
+{
+  size_t bytes = nmemb * size;
+  unsigned long usage = __atomic_load_n( &_memory_usage, __ATOMIC_RELAXED );
+
+  /* reserve the bytes, unless they would pass the limit */
+  do
+    if( usage + bytes > __atomic_load_n( &_memory_limit, __ATOMIC_RELAXED ) )
+      return NULL;
+  while( !__atomic_compare_exchange_n( &_memory_usage, &usage, usage + bytes, 1,
+                                       __ATOMIC_RELAXED, __ATOMIC_RELAXED ) );
+
+  union BlockHeader * header = calloc( 1, sizeof( union BlockHeader ) + bytes );
+  if( header == NULL )
+    {
+      __atomic_fetch_sub( &_memory_usage, bytes, __ATOMIC_RELAXED );
+      return NULL;
+    }
+
+  header->size = bytes;
+  return header + 1;
+}
+
+/**
+ * Free memory
+ *
+ * Frees memory from Calloc(), and decreases the memory usage tracked by
+ * the block's size
+ *
+ * @param ptr to memory to free, may be null
+ */
+void Free( void * ptr )
+{
+  if( ptr == NULL )
+    return;
+
+  union BlockHeader * header = (union BlockHeader *) ptr - 1;
+
+  __atomic_fetch_sub( &_memory_usage, header->size, __ATOMIC_RELAXED );
+  free( header );
+}
+
+/**
+ * Get the memory used by the program
+ *
+ * @return the memory used, in bytes
+ */
+unsigned long memory_usage( void )
+{
+  return __atomic_load_n( &_memory_usage, __ATOMIC_RELAXED );
+}
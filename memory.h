@@ -0,0 +1,22 @@
+/**
+ * @file memory.h
+ * @brief this file provides memory allocation routines, and memory tracking functions
+ * @author Eric Watkins, Julian Martinez del Campo, Michael Hnatiw
+ *
+ * The allocator does not depend on the board size. It is built once and
+ * shared by every size's build, so one limit covers the whole program.
+ */
+#ifndef _MEMORY_H_
+#define _MEMORY_H_
+
+#include <stddef.h>
+
+/** default limit on the memory Calloc() hands out, in megabytes */
+#define MEMORYSIZE 512
+
+void set_memory_limit( unsigned long bytes );
+void * Calloc( size_t nmemb, size_t size );
+void Free( void * ptr );
+unsigned long memory_usage( void );
+
+#endif /* _MEMORY_H_ */
@@ -15,8 +15,6 @@
 #include "move.h"
 #include "utility.h"
 
-#define STR_LEN 12
-
 /**
  * Create a new move
  *
@@ -47,12 +45,10 @@ struct Move * create_move( short start_row, short start_col, short end_row, shor
  */
 char num2letter( int i )
 {
-    static char letters[ 8 ] = { 'A', 'B', 'C', 'D', 'E', 'F', 'G', 'H' };
-
-    if( i < 0 || i > 8 )
+    if( i < 0 || i >= SIZE )
         return 'X';
 
-    return letters[i];
+    return 'A' + i;
 }
 
 /**
@@ -123,9 +119,9 @@ struct Move * str2move( const char * move )
     int length = strnlen( move, 20 );
     int i;
     int valid = 0;
-    char start_row[2];
+    int start_row = 0;
     char start_col[2];
-    char end_row[2];
+    int end_row = 0;
     char end_col[2];
 
     /* find first letter */
@@ -142,8 +138,8 @@ struct Move * str2move( const char * move )
     for( ; i< length; i++ )
         if( isdigit( move[i] ) )
         {
-            start_row[0] = move[ i ];
-            start_row[1] = '\0';
+            /* rows past 9 take two digits */
+            start_row = atoi( &move[ i ] );
             valid++;
             break;
         }
@@ -162,8 +158,7 @@ struct Move * str2move( const char * move )
     for( ; i < length; i++ )
         if( isdigit( move[ i ] ) )
         {
-            end_row[0] = move[ i ];
-            end_row[1] = '\0';
+            end_row = atoi( &move[ i ] );
             valid++;
             break;
         }
@@ -179,9 +174,9 @@ struct Move * str2move( const char * move )
             atoi( end_col ) - 1 );
             */
     struct Move * translated_move = create_move( 
-            SIZE - atoi( start_row ),
+            SIZE - start_row,
             letter2num( start_col[0] ),
-            SIZE - atoi( end_row ),
+            SIZE - end_row,
             letter2num( end_col[0] ) );
 
     return translated_move;
@@ -198,7 +193,7 @@ struct Move * first_str2move( const char * move )
     int length = strnlen( move, 20 );
     int i;
     int valid = 0;
-    char start_row[2];
+    int start_row = 0;
     char start_col[2];
 
     /* find first letter */
@@ -215,8 +210,8 @@ struct Move * first_str2move( const char * move )
     for( ; i< length; i++ )
         if( isdigit( move[i] ) )
         {
-            start_row[0] = move[ i ];
-            start_row[1] = '\0';
+            /* rows past 9 take two digits */
+            start_row = atoi( &move[ i ] );
             valid++;
             break;
         }
@@ -226,7 +221,7 @@ struct Move * first_str2move( const char * move )
         return NULL;
 
     struct Move * translated_move = create_move( 
-            SIZE - atoi( start_row ),
+            SIZE - start_row,
             letter2num( start_col[0] ),
             0,
             0 );
@@ -234,6 +229,59 @@ struct Move * first_str2move( const char * move )
     return translated_move;
 }
 
+/**
+ * Write a move as one word, a removal as its square, D5, and a jump as its
+ * start and end, D5-D3
+ *
+ * @param move a move, a removal has the same start and end
+ * @param token set to the word
+ */
+void move2token( const struct Move * move, char token[ TOKEN_LEN ] )
+{
+    if( move->start_row == move->end_row && move->start_col == move->end_col )
+        snprintf( token, TOKEN_LEN, "%c%d", num2letter( move->start_col ),
+                  SIZE - move->start_row );
+    else
+        snprintf( token, TOKEN_LEN, "%c%d-%c%d", num2letter( move->start_col ),
+                  SIZE - move->start_row, num2letter( move->end_col ),
+                  SIZE - move->end_row );
+}
+
+/**
+ * Read a move written by move2token()
+ *
+ * @param token a word
+ * @param move set to the move
+ * @return 1 if the word is a move between squares of the board, else return 0
+ */
+int token2move( const char * token, struct Move * move )
+{
+    char start_col, end_col;
+    int start_row, end_row;
+    int length = 0;
+    int more = 0;
+
+    if( sscanf( token, "%c%d%n", &start_col, &start_row, &length ) != 2 )
+        return 0;
+
+    end_col = start_col;
+    end_row = start_row;
+    if( token[ length ] == '-' &&
+        sscanf( token + length, "-%c%d%n", &end_col, &end_row, &more ) == 2 )
+        length += more;
+
+    move->start_row = SIZE - start_row;
+    move->start_col = letter2num( start_col );
+    move->end_row = SIZE - end_row;
+    move->end_col = letter2num( end_col );
+
+    return token[ length ] == '\0' &&
+           move->start_row >= 0 && move->start_row < SIZE &&
+           move->start_col >= 0 && move->start_col < SIZE &&
+           move->end_row >= 0 && move->end_row < SIZE &&
+           move->end_col >= 0 && move->end_col < SIZE;
+}
+
 /**
  * Compare a move
  *
@@ -266,7 +314,7 @@ void print_move( const struct Move * move )
 
     printf( ": %s", human_readable );
 
-    Free( human_readable, sizeof( char ) * STR_LEN );
+    Free( human_readable );
 }
 
 /**
@@ -284,7 +332,7 @@ void print_single_move( const struct Move * move )
 
     printf( ": %s", human_readable );
 
-    Free( human_readable, sizeof( char ) * STR_LEN );
+    Free( human_readable );
 }
 
 /**
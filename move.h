@@ -7,6 +7,8 @@
 #ifndef _MOVE_H_
 #define _MOVE_H_
 
+#include "bitboard.h"
+
 /** A move */
 struct Move {
     short start_row;
@@ -15,6 +17,28 @@ struct Move {
     short end_col;
 };
 
+/**
+ * Upper bound on the moves in any position. A jump starts from a piece
+ * followed by an opponent, so a line holds at most SIZE / 2 starts per
+ * direction, and each start can stop after any of its (SIZE - 1) / 2 jumps.
+ */
+#define MAX_MOVES ( 4 * SIZE * ( SIZE / 2 ) * ( ( SIZE - 1 ) / 2 ) )
+
+/** upper bound on the plies of a game, every move captures a piece */
+#define MAX_PLY ( SIZE * SIZE )
+
+/** length of the strings made by move2str() and first_move2str() */
+#define STR_LEN 12
+
+/** length of the words made by move2token(), room for any short */
+#define TOKEN_LEN 16
+
+/** A fixed capacity list of moves, meant to live on the stack */
+struct MoveList {
+    int count;                          /**< number of moves */
+    struct Move moves[ MAX_MOVES ];     /**< moves, stored by value */
+};
+
 #if 1
 
 struct Move *   create_move( short start_row, short start_col, short end_row, short end_col );
@@ -24,6 +48,8 @@ struct Move *   str2move( const char * move );
 char *          first_move2str( const struct Move * first_move );
 struct Move *   str2first_move( const char * move );
 struct Move *   first_str2move( const char * move );
+void            move2token( const struct Move * move, char token[ TOKEN_LEN ] );
+int             token2move( const char * token, struct Move * move );
 int             compare_move( const struct Move * a, const struct Move * b );
 char            num2letter( int i );
 int             letter2num( char letter );
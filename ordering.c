@@ -0,0 +1,146 @@
+/**
+ * @file ordering.c
+ * @author Eric Watkins, Julian Martinez del Campo, Michael Hnatiw
+ *
+ * This file provides an implementation of ordering.h
+ */
+#include <string.h>
+#include <stdlib.h>
+
+#include "ordering.h"
+#include "konane.h"
+#include "move.h"
+
+#define HASH_SCORE      ( 1 << 30 )
+#define KILLER_SCORE    ( 1 << 29 )
+#define CAPTURE_SHIFT   24
+#define HISTORY_MAX     ( ( 1 << CAPTURE_SHIFT ) - 1 )
+
+/**
+ * Count the pieces a move captures
+ *
+ * @param move a move
+ * @return the number of jumps in move
+ */
+static int captures( const struct Move * move )
+{
+    return ( abs( move->end_row - move->start_row ) +
+             abs( move->end_col - move->start_col ) ) / 2;
+}
+
+/**
+ * Score moves for ordering, higher first
+ *
+ * @param search the running search
+ * @param moves the moves of a node
+ * @param ply the node's distance from the root
+ * @param hash_move the move to search first, or null
+ * @param scores set to the score of each move
+ * @return 1 if hash_move is in moves, else return 0
+ */
+int score_moves( const struct Search * search, const struct MoveList * moves, int ply,
+                 const struct Move * hash_move, int scores[] )
+{
+    int found = 0;
+
+    for( int i = 0; i < moves->count; i++ )
+    {
+        const struct Move * move = &moves->moves[ i ];
+
+        if( hash_move != NULL && compare_move( move, hash_move ) )
+        {
+            scores[ i ] = HASH_SCORE;
+            found = 1;
+        }
+        else if( compare_move( move, &search->killers[ ply ][ 0 ] ) )
+            scores[ i ] = KILLER_SCORE;
+        else if( compare_move( move, &search->killers[ ply ][ 1 ] ) )
+            scores[ i ] = KILLER_SCORE - 1;
+        else
+            scores[ i ] = ( captures( move ) << CAPTURE_SHIFT ) +
+                search->history[ BB_INDEX( move->start_row, move->start_col ) ]
+                               [ BB_INDEX( move->end_row, move->end_col ) ];
+    }
+
+    return found;
+}
+
+/**
+ * Bring the best scored of the remaining moves forward
+ *
+ * Moves are picked one at a time, so a cutoff saves sorting the rest.
+ *
+ * @param moves the moves of a node
+ * @param scores the score of each move
+ * @param index the position to fill, every move before it has been picked
+ */
+void pick_move( struct MoveList * moves, int scores[], int index )
+{
+    int best = index;
+
+    for( int i = index + 1; i < moves->count; i++ )
+        if( scores[ i ] > scores[ best ] )
+            best = i;
+
+    if( best != index )
+    {
+        struct Move move = moves->moves[ index ];
+        int score = scores[ index ];
+
+        moves->moves[ index ] = moves->moves[ best ];
+        scores[ index ] = scores[ best ];
+        moves->moves[ best ] = move;
+        scores[ best ] = score;
+    }
+}
+
+/**
+ * Remember a move that caused a cutoff
+ *
+ * The move becomes the first killer of its ply, and its history score grows
+ * with the square of the plies searched below it.
+ *
+ * @param search the running search
+ * @param move the move that caused the cutoff
+ * @param ply the node's distance from the root
+ * @param draft the plies searched below the node
+ */
+void record_cutoff( struct Search * search, const struct Move * move, int ply, int draft )
+{
+    if( !compare_move( move, &search->killers[ ply ][ 0 ] ) )
+    {
+        search->killers[ ply ][ 1 ] = search->killers[ ply ][ 0 ];
+        search->killers[ ply ][ 0 ] = *move;
+    }
+
+    int * history = &search->history[ BB_INDEX( move->start_row, move->start_col ) ]
+                                    [ BB_INDEX( move->end_row, move->end_col ) ];
+    *history += draft * draft;
+
+    /* keep history below the capture bonus by halving every score */
+    if( *history > HISTORY_MAX )
+        age_history( search );
+}
+
+/**
+ * Halve every history score, so that new cutoffs count for more than old
+ *
+ * @param search a search
+ */
+void age_history( struct Search * search )
+{
+    for( int i = 0; i < SIZE * SIZE; i++ )
+        for( int j = 0; j < SIZE * SIZE; j++ )
+            search->history[ i ][ j ] /= 2;
+}
+
+/**
+ * Forget all killer moves and history
+ *
+ * @param search a search
+ */
+void clear_ordering( struct Search * search )
+{
+    memset( search->killers, 0, sizeof( search->killers ) );
+    memset( search->history, 0, sizeof( search->history ) );
+}
@@ -0,0 +1,22 @@
+/**
+ * @file ordering.h
+ * @author Eric Watkins, Julian Martinez del Campo, Michael Hnatiw
+ *
+ * This file provides move ordering for the search: the hash move first,
+ * then the killer moves of the ply, then the other moves by capture
+ * length and history
+ */
+#ifndef _ORDERING_H_
+#define _ORDERING_H_
+
+#include "konane.h"
+#include "move.h"
+
+int score_moves( const struct Search * search, const struct MoveList * moves, int ply,
+                 const struct Move * hash_move, int scores[] );
+void pick_move( struct MoveList * moves, int scores[], int index );
+void record_cutoff( struct Search * search, const struct Move * move, int ply, int draft );
+void age_history( struct Search * search );
+void clear_ordering( struct Search * search );
+
+#endif /* _ORDERING_H_ */
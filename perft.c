@@ -0,0 +1,155 @@
+/**
+ * @file perft.c
+ * @author Eric Watkins, Julian Martinez del Campo, Michael Hnatiw
+ *
+ * Count the leaves of the move tree to a fixed depth. The counts verify
+ * actions() and make_move()/unmake_move(), and the timing measures them.
+ */
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <ctype.h>
+#include <pthread.h>
+
+#include "konane.h"
+#include "state.h"
+#include "move.h"
+#include "clock.h"
+#include "utility.h"
+
+/** work shared by the perft threads */
+struct PerftJob {
+    struct State root;              /**< the position to count from */
+    struct MoveList moves;          /**< the root moves */
+    unsigned long long * counts;    /**< leaf count under each root move */
+    int depth;                      /**< depth to count to */
+    int next;                       /**< next root move to take */
+    pthread_mutex_t lock;           /**< guards next */
+};
+
+/**
+ * Count the leaves below a state
+ *
+ * @param state a state, restored before returning
+ * @param depth the number of plies to count
+ * @return the number of positions depth plies below state
+ */
+static unsigned long long perft( struct State * state, int depth )
+{
+    if( depth == 0 )
+        return 1;
+
+    /* the last ply only needs to be counted */
+    if( depth == 1 )
+        return count_moves( state );
+
+    unsigned long long leaves = 0;
+    struct MoveList moves;
+    actions( state, &moves );
+
+    for( int i = 0; i < moves.count; i++ )
+    {
+        struct Undo undo = make_move( state, &moves.moves[ i ] );
+        leaves += perft( state, depth - 1 );
+        unmake_move( state, &moves.moves[ i ], undo );
+    }
+
+    return leaves;
+}
+
+/**
+ * Count the leaves under root moves until none are left
+ *
+ * @param arg the shared perft job
+ * @return null
+ */
+static void * perft_worker( void * arg )
+{
+    struct PerftJob * job = arg;
+
+    for( ;; )
+    {
+        pthread_mutex_lock( &job->lock );
+        int i = job->next++;
+        pthread_mutex_unlock( &job->lock );
+
+        if( i >= job->moves.count )
+            break;
+
+        struct State state = job->root;
+        make_move( &state, &job->moves.moves[ i ] );
+        job->counts[ i ] = perft( &state, job->depth - 1 );
+    }
+
+    return NULL;
+}
+
+int main( int argc, char * argv[] )
+{
+    if( argc != 4 && argc != 5 )
+    {
+        printf( "%s usage: <input file> <player color> <depth> [threads]\n", argv[ 0 ] );
+        printf( "   input file - a text file consisting of a konane board\n" );
+        printf( "   player color - B or W, the player to move\n" );
+        printf( "   depth - the number of plies to count, at least 1\n" );
+        printf( "   threads - the number of threads to divide root moves over\n" );
+        return EXIT_FAILURE;
+    }
+
+    char board[ SIZE ][ SIZE ];
+    struct PerftJob job;
+    int threads = ( argc == 5 ) ? atoi( argv[ 4 ] ) : 1;
+
+    job.depth = atoi( argv[ 3 ] );
+    if( job.depth < 1 || threads < 1 )
+    {
+        printf( "depth and threads must be at least 1\n" );
+        return EXIT_FAILURE;
+    }
+
+    /* set up board */
+    setup_board( argv[ 1 ], board );
+    struct State * state = new_state( board, toupper( argv[ 2 ][ 0 ] ) );
+    job.root = *state;
+    Free( state );
+
+    actions( &job.root, &job.moves );
+    job.counts = Calloc( job.moves.count + 1, sizeof( unsigned long long ) );
+    job.next = 0;
+    pthread_mutex_init( &job.lock, NULL );
+
+    /* divide the root moves over the threads */
+    pthread_t * workers = Calloc( threads, sizeof( pthread_t ) );
+    millis start = clock_ms();
+
+    for( int i = 0; i < threads; i++ )
+        pthread_create( &workers[ i ], NULL, perft_worker, &job );
+    for( int i = 0; i < threads; i++ )
+        pthread_join( workers[ i ], NULL );
+
+    double elapsed = ( clock_ms() - start ) / 1000.0;
+
+    /* print leaves per root move */
+    unsigned long long total = 0;
+    for( int i = 0; i < job.moves.count; i++ )
+    {
+        char * move = move2str( &job.moves.moves[ i ] );
+        printf( "%s: %llu\n", move, job.counts[ i ] );
+        Free( move );
+
+        total += job.counts[ i ];
+    }
+
+    printf( "\nMoves: %d\n", job.moves.count );
+    printf( "Nodes: %llu\n", total );
+    printf( "Time: %.3f s\n", elapsed );
+    if( elapsed > 0 )
+        printf( "Nodes/second: %.0f\n", total / elapsed );
+
+    pthread_mutex_destroy( &job.lock );
+    Free( workers );
+    Free( job.counts );
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,173 @@
+/**
+ * @brief Play a game of konane
+ * @author Eric Watkins, Julian Martinez del Campo, Michael Hnatiw
+ *
+ * This is the game program for one board size, SIZE. It is built once per
+ * size, and main.c runs the build for the size of the board file.
+ */
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include "game.h"
+#include "book.h"
+#include "konane.h"
+#include "tablebase.h"
+#include "utility.h"
+
+/**
+ * Print how to run the program
+ *
+ * @param name the program name
+ */
+static void usage( const char * name )
+{
+    printf( "%s usage: [-b book] [-c seconds [-i seconds]] [-e] [-l megabytes] [-m megabytes] [-p] [-t threads] [-T tablebase] [-y] <input file> <player color>\n", name );
+    printf( "   input file - a text file consisting of a konane board\n" );
+    printf( "   player color - a single character B, W which indicates the \n" );
+    printf( "       role the agent assumes. If player color is not equal \n" );
+    printf( "       to b or w, then game enters interactive mode\n" );
+    printf( "   -b book - opening book written by bookgen\n" );
+    printf( "   -c seconds - the computer's time for the whole game, instead of \n" );
+    printf( "       a fixed time per move\n" );
+    printf( "   -e - speak the engine protocol on stdin and stdout instead of \n" );
+    printf( "       playing a game, without input file and player color\n" );
+    printf( "   -i seconds - time added to the game clock after each move\n" );
+    printf( "   -l megabytes - limit on all memory used (default %d)\n", MEMORYSIZE );
+    printf( "   -m megabytes - memory for the transposition table (default %d)\n", TRANS_TABLE_MB );
+    printf( "   -p - think during the human's turn\n" );
+    printf( "   -t threads - threads searching each move (default 1)\n" );
+    printf( "   -T tablebase - endgame tablebase written by tbgen\n" );
+    printf( "   -y - split the tree between the threads (young brothers wait) \n" );
+    printf( "       instead of only sharing the transposition table\n" );
+}
+
+/**
+ * Read the program's options and set the search up for them
+ *
+ * With -e, a book or tablebase built for another board size is left for
+ * the engine of that size; in a game it is an error.
+ *
+ * @param argc the number of arguments
+ * @param argv the arguments
+ * @param protocol set to 1 if -e asks for the engine protocol, else 0
+ * @return the index of the first argument after the options, or -1 if the
+ * options are wrong
+ */
+int configure( int argc, char * argv[], int * protocol )
+{
+    int option;
+    int loaded;
+    const char * other_book = NULL;
+    const char * other_tablebase = NULL;
+    size_t table_size = 0;
+    unsigned long memory_limit = MEMORYSIZE;
+    double game_time = 0;
+    double increment = 0;
+
+    *protocol = 0;
+
+    while( ( option = getopt( argc, argv, "b:c:ei:l:m:pt:T:y" ) ) != -1 )
+    {
+        switch( option )
+        {
+        case 'b':
+            loaded = load_book( optarg );
+            if( loaded == 0 )
+            {
+                printf( "%s is not an opening book\n", optarg );
+                return -1;
+            }
+            if( loaded < 0 )
+                other_book = optarg;
+            break;
+        case 'c':
+            game_time = atof( optarg );
+            break;
+        case 'e':
+            *protocol = 1;
+            break;
+        case 'i':
+            increment = atof( optarg );
+            break;
+        case 'l':
+            memory_limit = strtoul( optarg, NULL, 10 );
+            set_memory_limit( memory_limit * 1024UL * 1024UL );
+            break;
+        case 'm':
+            table_size = atoi( optarg );
+            break;
+        case 'p':
+            set_ponder( 1 );
+            break;
+        case 't':
+            set_search_threads( atoi( optarg ) );
+            break;
+        case 'T':
+            loaded = load_tablebase( optarg );
+            if( loaded == 0 )
+            {
+                printf( "%s is not a tablebase\n", optarg );
+                return -1;
+            }
+            if( loaded < 0 )
+                other_tablebase = optarg;
+            break;
+        case 'y':
+            set_search_split( 1 );
+            break;
+        default:
+            usage( argv[ 0 ] );
+            return -1;
+        }
+    }
+
+    if( other_book != NULL && !*protocol )
+    {
+        printf( "%s is a book for another board size\n", other_book );
+        return -1;
+    }
+
+    if( other_tablebase != NULL && !*protocol )
+    {
+        printf( "%s has windows larger than the board\n", other_tablebase );
+        return -1;
+    }
+
+    if( table_size > memory_limit )
+    {
+        printf( "a transposition table of %zu megabytes passes the memory limit of %lu\n",
+                table_size, memory_limit );
+        return -1;
+    }
+
+    if( game_time > 0 )
+        set_game_clock( game_time * 1000, increment * 1000 );
+
+    /* the table is made once the memory limit is known */
+    if( table_size > 0 )
+        set_trans_table_size( table_size );
+
+    return optind;
+}
+
+int main( int argc, char * argv[] )
+{
+    int protocol;
+    int first = configure( argc, argv, &protocol );
+
+    if( first < 0 )
+        return EXIT_FAILURE;
+
+    if( protocol || argc - first != 2 )
+    {
+        usage( argv[ 0 ] );
+        return EXIT_FAILURE;
+    }
+
+    char * str = argv[ first + 1 ];
+    game( argv[ first ], str[ 0 ] );
+    
+  return EXIT_SUCCESS;
+}
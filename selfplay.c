@@ -0,0 +1,414 @@
+/**
+ * @file selfplay.c
+ * @author Eric Watkins, Julian Martinez del Campo, Michael Hnatiw
+ *
+ * Play the computer against itself for many games at once, without printing
+ * the boards: each worker process plays its share of the games and writes
+ * one line per game, the winner, plies, nodes and time. The games start
+ * from every opening removal in turn, distinct up to the board's
+ * symmetries, followed by random moves.
+ */
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+
+#include "book.h"
+#include "symmetry.h"
+#include "konane.h"
+#include "tablebase.h"
+#include "state.h"
+#include "move.h"
+#include "game_node.h"
+#include "arena.h"
+#include "clock.h"
+#include "utility.h"
+
+#define MOVE_TEXT 8         /* longest move written by move_text(), with its comma */
+#define LINE_SIZE ( 128 + MAX_PLY * MOVE_TEXT )  /* longest line a worker writes for a game */
+
+/** a start of the games: the position after the opening removals */
+struct Opening {
+    struct State state;                         /**< the position */
+    int plies;                                  /**< removals played */
+    char text[ 2 * MOVE_TEXT + 1 ];             /**< the removals, as move_text() */
+};
+
+/** the distinct openings of the board */
+static struct Opening openings[ MAX_REMOVALS * MAX_REMOVALS ];
+static int opening_count = 0;
+
+/** how each game is played */
+static int random_plies = 0;
+static unsigned int seed = 1;
+static millis move_time = 1000;
+static millis game_time = 0;
+static millis increment = 0;
+static size_t table_size = 0;
+
+/** arena of the search trees */
+static struct Arena * arena = NULL;
+
+/**
+ * Write a move after the moves already in a text
+ *
+ * @param text a string to append the move to, separated by a comma
+ * @param move a removal, with the same start and end, or a jump
+ */
+static void move_text( char * text, const struct Move * move )
+{
+    char token[ TOKEN_LEN ];
+
+    move2token( move, token );
+    if( text[ 0 ] != '\0' )
+        strcat( text, "," );
+    strcat( text, token );
+}
+
+/**
+ * Find the openings reached by the removals from a position
+ *
+ * An opening that is an image of one already found is left out, as it
+ * would play the same game turned.
+ *
+ * @param opening the position and the removals that led to it
+ */
+static void find_openings( const struct Opening * opening )
+{
+    struct Move moves[ MAX_REMOVALS ];
+    int count = 0;
+    int symmetry;
+
+    if( popcount( empty_squares( &opening->state ) ) <= 1 )
+        count = removals( &opening->state, moves );
+
+    for( int i = 0; i < count; i++ )
+    {
+        struct Opening after = *opening;
+
+        set_piece( &after.state, moves[ i ].start_row, moves[ i ].start_col, 'O' );
+        after.state.player = opposite_player( opening->state.player );
+        after.plies++;
+        move_text( after.text, &moves[ i ] );
+
+        find_openings( &after );
+    }
+
+    if( count > 0 )
+        return;
+
+    uint64_t key = canonical_key( &opening->state, &symmetry );
+    for( int i = 0; i < opening_count; i++ )
+        if( canonical_key( &openings[ i ].state, &symmetry ) == key )
+            return;
+
+    openings[ opening_count++ ] = *opening;
+}
+
+/**
+ * Choose the computer's move
+ *
+ * @param state a state whose player has a move
+ * @param move set to the move
+ * @return the nodes searched for the move
+ */
+static unsigned long choose_move( const struct State * state, struct Move * move )
+{
+    struct BookEntry entry;
+
+    if( probe_book( state, &entry ) && validate_action( state, &entry.move ) )
+    {
+        *move = entry.move;
+        return 0;
+    }
+
+    struct State root_state = *state;
+    struct GameNode * root = new_game_node( arena, &root_state, NULL );
+
+    alpha_beta_search( root );
+
+    *move = root->pv[ 0 ];
+    unsigned long nodes = root->nodes;
+
+    Free( root->best_move );
+    reset_arena( arena );
+
+    return nodes;
+}
+
+/**
+ * Play one game, the computer against itself
+ *
+ * @param game the game's number, choosing its opening and random moves
+ * @param line set to the game's summary line
+ */
+static void play_game( int game, char line[ LINE_SIZE ] )
+{
+    const struct Opening * opening = &openings[ game % opening_count ];
+    struct State state = opening->state;
+    char text[ sizeof( opening->text ) + MAX_PLY * MOVE_TEXT ];
+    unsigned int random = seed + game;
+    unsigned long nodes = 0;
+    int plies = opening->plies;
+
+    strcpy( text, opening->text );
+
+    reset_search();
+    if( game_time > 0 )
+        set_game_clock( game_time, increment );
+    else
+        set_move_time( move_time );
+
+    millis start = clock_ms();
+
+    /* random moves after the removals, so that games of an opening differ */
+    for( int i = 0; i < random_plies; i++ )
+    {
+        struct MoveList moves;
+
+        if( actions( &state, &moves ) == 0 )
+            break;
+
+        struct Move * move = &moves.moves[ rand_r( &random ) % moves.count ];
+        move_text( text, move );
+        make_move( &state, move );
+        plies++;
+    }
+
+    while( has_moves( &state ) )
+    {
+        struct Move move;
+
+        nodes += choose_move( &state, &move );
+        make_move( &state, &move );
+        plies++;
+    }
+
+    snprintf( line, LINE_SIZE, "game %d: winner %c, plies %d, nodes %lu, time %.3f s, opening %s\n",
+              game, opposite_player( state.player ), plies, nodes,
+              ( clock_ms() - start ) / 1000.0, text );
+}
+
+/**
+ * Play every step-th game from first, writing a line for each
+ *
+ * @param first the first game to play
+ * @param games the games to play
+ * @param step the number of workers
+ * @param fd where to write the lines
+ */
+static void worker( int first, int games, int step, int fd )
+{
+    char line[ LINE_SIZE ];
+
+    arena = new_arena( ARENA_CHUNK_SIZE );
+    if( table_size > 0 )
+        set_trans_table_size( table_size );
+
+    /* a line is shorter than PIPE_BUF, so the workers' lines do not mix */
+    for( int game = first; game < games; game += step )
+    {
+        play_game( game, line );
+        if( write( fd, line, strlen( line ) ) < 0 )
+            break;
+    }
+
+    delete_arena( &arena );
+}
+
+/**
+ * Print how to run the program
+ *
+ * @param name the program name
+ */
+static void usage( const char * name )
+{
+    printf( "%s usage: [-b book] [-c seconds [-i seconds]] [-d depth] [-m megabytes] [-r plies] [-R seed] [-s seconds] [-t threads] [-T tablebase] [-w workers] <input file> <games>\n", name );
+    printf( "   input file - a text file consisting of a konane board\n" );
+    printf( "   games - the number of games to play\n" );
+    printf( "   -b book - opening book written by bookgen\n" );
+    printf( "   -c seconds - each player's time for the whole game, instead of \n" );
+    printf( "       a fixed time per move\n" );
+    printf( "   -i seconds - time added to the game clock after each move\n" );
+    printf( "   -d depth - the most plies to search each move\n" );
+    printf( "   -m megabytes - memory for each worker's transposition table \n" );
+    printf( "       (default %d)\n", TRANS_TABLE_MB );
+    printf( "   -r plies - random moves played after the removals (default 0)\n" );
+    printf( "   -R seed - seed of the random moves, game n uses seed + n (default 1)\n" );
+    printf( "   -s seconds - time for each move (default 1)\n" );
+    printf( "   -t threads - threads searching each move (default 1)\n" );
+    printf( "   -T tablebase - endgame tablebase written by tbgen\n" );
+    printf( "   -w workers - games played at once (default a processor per \n" );
+    printf( "       search thread)\n" );
+}
+
+int main( int argc, char * argv[] )
+{
+    int option;
+    int loaded;
+    int threads = 1;
+    int workers = 0;
+
+    while( ( option = getopt( argc, argv, "b:c:d:i:m:r:R:s:t:T:w:" ) ) != -1 )
+    {
+        switch( option )
+        {
+        case 'b':
+            loaded = load_book( optarg );
+            if( loaded <= 0 )
+            {
+                printf( loaded ? "%s is a book for another board size\n" : "%s is not an opening book\n", optarg );
+                return EXIT_FAILURE;
+            }
+            break;
+        case 'c':
+            game_time = atof( optarg ) * 1000;
+            break;
+        case 'd':
+            set_search_depth( atoi( optarg ) );
+            break;
+        case 'i':
+            increment = atof( optarg ) * 1000;
+            break;
+        case 'm':
+            table_size = atoi( optarg );
+            break;
+        case 'r':
+            random_plies = atoi( optarg );
+            break;
+        case 'R':
+            seed = strtoul( optarg, NULL, 10 );
+            break;
+        case 's':
+            move_time = atof( optarg ) * 1000;
+            break;
+        case 't':
+            threads = atoi( optarg );
+            break;
+        case 'T':
+            loaded = load_tablebase( optarg );
+            if( loaded <= 0 )
+            {
+                printf( loaded ? "%s has windows larger than the board\n" : "%s is not a tablebase\n", optarg );
+                return EXIT_FAILURE;
+            }
+            break;
+        case 'w':
+            workers = atoi( optarg );
+            break;
+        default:
+            usage( argv[ 0 ] );
+            return EXIT_FAILURE;
+        }
+    }
+
+    if( argc - optind != 2 )
+    {
+        usage( argv[ 0 ] );
+        return EXIT_FAILURE;
+    }
+
+    int games = atoi( argv[ optind + 1 ] );
+    if( games < 1 || move_time <= 0 || random_plies < 0 || random_plies > MAX_PLY )
+    {
+        printf( "games and seconds must be positive, plies from 0 to %d\n", MAX_PLY );
+        return EXIT_FAILURE;
+    }
+
+    char board[ SIZE ][ SIZE ];
+    setup_board( argv[ optind ], board );
+
+    struct Opening start = { 0 };
+    struct State * state = new_state( board, 'B' );
+    start.state = *state;
+    Free( state );
+    find_openings( &start );
+
+    set_search_threads( threads );
+    if( threads < 1 )
+        threads = 1;
+    if( workers < 1 )
+        workers = sysconf( _SC_NPROCESSORS_ONLN ) / threads;
+    if( workers < 1 )
+        workers = 1;
+    if( workers > games )
+        workers = games;
+
+    printf( "Openings: %d\n", opening_count );
+    printf( "Workers: %d\n", workers );
+    fflush( stdout );
+
+    /* each worker is a process of its own, as the search's tables are */
+    int lines[ 2 ];
+    if( pipe( lines ) != 0 )
+    {
+        printf( "could not make a pipe\n" );
+        return EXIT_FAILURE;
+    }
+
+    millis started = clock_ms();
+    for( int i = 0; i < workers; i++ )
+    {
+        pid_t pid = fork();
+
+        if( pid < 0 )
+        {
+            printf( "could not start worker %d\n", i );
+            workers = i;
+            break;
+        }
+
+        if( pid == 0 )
+        {
+            close( lines[ 0 ] );
+            worker( i, games, workers, lines[ 1 ] );
+            close( lines[ 1 ] );
+            _exit( EXIT_SUCCESS );
+        }
+    }
+    close( lines[ 1 ] );
+
+    /* pass the lines on as they come, adding up the results */
+    FILE * results = fdopen( lines[ 0 ], "r" );
+    char line[ LINE_SIZE ];
+    int played = 0;
+    int black_wins = 0;
+    unsigned long total_nodes = 0;
+
+    while( results != NULL && fgets( line, sizeof( line ), results ) != NULL )
+    {
+        int game, plies;
+        char winner;
+        unsigned long nodes;
+
+        fputs( line, stdout );
+        fflush( stdout );
+
+        if( sscanf( line, "game %d: winner %c, plies %d, nodes %lu", &game, &winner, &plies, &nodes ) == 4 )
+        {
+            played++;
+            black_wins += ( winner == 'B' );
+            total_nodes += nodes;
+        }
+    }
+
+    if( results != NULL )
+        fclose( results );
+    for( int i = 0; i < workers; i++ )
+        wait( NULL );
+
+    millis elapsed = clock_ms() - started;
+
+    printf( "Games: %d\n", played );
+    printf( "Black wins: %d\n", black_wins );
+    printf( "White wins: %d\n", played - black_wins );
+    printf( "Nodes: %lu\n", total_nodes );
+    printf( "Time: %.3f s\n", elapsed / 1000.0 );
+    printf( "Nodes/second: %.0f\n", elapsed > 0 ? total_nodes * 1000.0 / elapsed : 0.0 );
+
+    return ( played == games ) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,74 @@
+/**
+ * @file sizes.c
+ * @author Eric Watkins, Julian Martinez del Campo, Michael Hnatiw
+ *
+ * This file provides an implementation of sizes.h
+ */
+#include <stdio.h>
+
+#include "sizes.h"
+
+/**
+ * Find the size of a board file
+ *
+ * @param path a file
+ * @return n if the file holds n rows of n squares, each B, W or O, else
+ * return 0
+ */
+int board_size( const char * path )
+{
+    FILE * fh = fopen( path, "r" );
+    int rows = 0, cols = 0, width = 0, fits = 1;
+    int c;
+
+    if( fh == NULL )
+        return 0;
+
+    while( fits && ( c = fgetc( fh ) ) != EOF )
+    {
+        if( c != '\n' )
+        {
+            fits = ( c == 'B' || c == 'W' || c == 'O' );
+            cols++;
+        }
+        else if( cols > 0 )
+        {
+            fits = ( rows == 0 || cols == width );
+            width = cols;
+            rows++;
+            cols = 0;
+        }
+    }
+
+    fclose( fh );
+
+    if( fits && cols > 0 )
+    {
+        fits = ( rows == 0 || cols == width );
+        width = cols;
+        rows++;
+    }
+
+    return ( fits && rows == width ) ? rows : 0;
+}
+
+/**
+ * Find the board size a program is run for
+ *
+ * @param argc the number of arguments
+ * @param argv the arguments
+ * @return the size of the first argument that is a board file, else
+ * return DEFAULT_SIZE
+ */
+int find_board_size( int argc, char * argv[] )
+{
+    for( int i = 1; i < argc; i++ )
+    {
+        int size = board_size( argv[ i ] );
+
+        if( size > 0 )
+            return size;
+    }
+
+    return DEFAULT_SIZE;
+}
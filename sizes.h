@@ -0,0 +1,24 @@
+/**
+ * @file sizes.h
+ * @author Eric Watkins, Julian Martinez del Campo, Michael Hnatiw
+ *
+ * This file provides the board sizes the programs are built for. Every
+ * module and program body is built once per size with SIZE fixed, so each
+ * size keeps its constant masks and loops, and the symbols of the size n
+ * build are prefixed with size<n>_, main becoming size8_main. The entry
+ * point, which does not depend on SIZE, reads the board file's size once
+ * and runs that build.
+ */
+#ifndef _SIZES_H_
+#define _SIZES_H_
+
+/** X( n ) for each size built, as SIZES in the Makefile */
+#define BOARD_SIZES( X ) X( 6 ) X( 8 ) X( 10 ) X( 12 ) X( 14 ) X( 16 )
+
+/** the size of a program run without a board file */
+#define DEFAULT_SIZE 8
+
+int board_size( const char * path );
+int find_board_size( int argc, char * argv[] );
+
+#endif /* _SIZES_H_ */
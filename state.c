@@ -25,15 +25,33 @@ struct State * new_state( char board[][SIZE], char player )
     struct State * state = Calloc( 1, sizeof( struct State ) );
     assert( state );
 
+    init_zobrist();
+
     for( int i = 0 ; i < SIZE; i++ )
         for( int j = 0; j < SIZE; j++ )
-            state->board[i][j] = board[i][j];
+            set_piece( state, i, j, board[i][j] );
 
     state->player = player;
 
     return state;
 }
 
+/**
+ * Clone a state
+ *
+ * @param state a state to clone
+ * @return a duplicate state
+ */
+struct State * clone_state( const struct State * state )
+{
+    struct State * clone = Calloc( 1, sizeof( struct State ) );
+    assert( clone );
+
+    *clone = *state;
+
+    return clone;
+}
+
 /**
  * Compare state
  * 
@@ -43,15 +61,75 @@ struct State * new_state( char board[][SIZE], char player )
  */
 int compare_state( const struct State * a, const struct State * b )
 {
-    if( a->player != b->player )
-        return 0;
+    return ( a->player == b->player &&
+             a->hash[ IDENTITY ] == b->hash[ IDENTITY ] &&
+             bb_equal( a->black, b->black ) &&
+             bb_equal( a->white, b->white ) );
+}
+
+/**
+ * Get the piece on a square
+ *
+ * @param state a state
+ * @param row the row of the square
+ * @param col the column of the square
+ * @return B or W if the square holds a piece, X if the square is off the
+ *  board, else return O
+ */
+char get_piece( const struct State * state, int row, int col )
+{
+    if( row < 0 || row >= SIZE || col < 0 || col >= SIZE )
+        return 'X';
 
+    bitboard square = BB_SQUARE( row, col );
+
+    if( !bb_none( bb_and( state->black, square ) ) )
+        return 'B';
+    if( !bb_none( bb_and( state->white, square ) ) )
+        return 'W';
+    return 'O';
+}
+
+/**
+ * Put a piece on a square
+ *
+ * @param state a state
+ * @param row the row of the square
+ * @param col the column of the square
+ * @param piece B or W to place a piece, anything else empties the square
+ */
+void set_piece( struct State * state, int row, int col, char piece )
+{
+    bitboard square = BB_SQUARE( row, col );
+    char old_piece = get_piece( state, row, col );
+
+    if( old_piece != 'O' )
+        toggle_piece( state->hash, old_piece, BB_INDEX( row, col ) );
+
+    state->black = bb_andnot( state->black, square );
+    state->white = bb_andnot( state->white, square );
+
+    if( piece == 'B' )
+        state->black = bb_or( state->black, square );
+    else if( piece == 'W' )
+        state->white = bb_or( state->white, square );
+    else
+        return;
+
+    toggle_piece( state->hash, piece, BB_INDEX( row, col ) );
+}
+
+/**
+ * Copy a state into a board
+ *
+ * @param state a state
+ * @param board a board to fill with B, W and O
+ */
+void state2board( const struct State * state, char board[][SIZE] )
+{
     for( int i = 0; i < SIZE; i++ )
         for( int j = 0; j < SIZE; j++ )
-            if( a->board[i][j] != b->board[i][j] )
-                return 0;
-
-    return 1;
+            board[i][j] = get_piece( state, i, j );
 }
 
 /**
@@ -75,9 +153,9 @@ void print_state( const struct State * state )
     for( int i = 0; i < SIZE; i++ )
     {
         //printf( "%d | ", i );
-        printf( "%d | ", SIZE - i );
+        printf( "%-2d| ", SIZE - i );
         for( int j = 0; j < SIZE; j++ )
-            printf( "%c ", state->board[i][j] );
+            printf( "%c ", get_piece( state, i, j ) );
         printf( "\n" );
     }
     printf( "\n" );
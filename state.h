@@ -7,17 +7,60 @@
 #ifndef _STATE_H_
 #define _STATE_H_
 
-#define SIZE 8
+#include <stdint.h>
+
+#include "bitboard.h"
+#include "zobrist.h"
 
 /** state */
 struct State {
-  char player;            /**< current player */
-  char board[SIZE][SIZE]; /**< board layout */
-  char _board[ SIZE * SIZE ]; /**< board */
+  bitboard black;                 /**< squares holding black pieces */
+  bitboard white;                 /**< squares holding white pieces */
+  uint64_t hash[ SYMMETRIES ];    /**< zobrist key of the pieces, moved by each symmetry */
+  char player;                    /**< current player */
 };
 
 struct State * new_state( char board[][SIZE], char player );
+struct State * clone_state( const struct State * state );
 int compare_state( const struct State * a, const struct State * b );
 void print_state( const struct State * state );
 
+char get_piece( const struct State * state, int row, int col );
+void set_piece( struct State * state, int row, int col, char piece );
+void state2board( const struct State * state, char board[][SIZE] );
+
+/**
+ * Get the pieces of a player
+ *
+ * @param state a state
+ * @param player B or W
+ * @return the squares holding the player's pieces
+ */
+static inline bitboard player_pieces( const struct State * state, char player )
+{
+    return player == 'B' ? state->black : state->white;
+}
+
+/**
+ * Get the key of a state, for hashing positions
+ *
+ * @param state a state
+ * @return the zobrist key of the pieces and the current player
+ */
+static inline uint64_t state_key( const struct State * state )
+{
+    return state->hash[ IDENTITY ] ^ ( state->player == 'W' ? zobrist_white_to_move : 0 );
+}
+
+/**
+ * Get the empty squares
+ *
+ * @param state a state
+ * @return the squares holding no piece
+ */
+static inline bitboard empty_squares( const struct State * state )
+{
+    return bb_andnot( BB_ALL, bb_or( state->black, state->white ) );
+}
+
 #endif /* _STATE_H_ */
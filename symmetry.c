@@ -0,0 +1,69 @@
+/**
+ * @file symmetry.c
+ * @author Eric Watkins, Julian Martinez del Campo, Michael Hnatiw
+ *
+ * This file provides an implementation of symmetry.h
+ */
+#include "symmetry.h"
+
+/**
+ * Move a move by a symmetry
+ *
+ * @param move a move to change in place
+ * @param symmetry a symmetry
+ */
+void transform_move( struct Move * move, int symmetry )
+{
+    int start = symmetric_square( BB_INDEX( move->start_row, move->start_col ), symmetry );
+    int end = symmetric_square( BB_INDEX( move->end_row, move->end_col ), symmetry );
+
+    move->start_row = start / SIZE;
+    move->start_col = start % SIZE;
+    move->end_row = end / SIZE;
+    move->end_col = end % SIZE;
+}
+
+/**
+ * Keep one move of each set of moves leading to mirrored positions
+ *
+ * If a symmetry leaves the state as it is, a move and its image lead to
+ * positions that are images of each other, and so have the same value.
+ * Only the first of them is kept.
+ *
+ * @param state a state
+ * @param moves the state's moves, changed in place
+ */
+void remove_symmetric_moves( const struct State * state, struct MoveList * moves )
+{
+    int symmetries[ SYMMETRIES ];
+    int count = 0;
+
+    for( int symmetry = 1; symmetry < SYMMETRIES; symmetry++ )
+        if( state->hash[ symmetry ] == state->hash[ IDENTITY ] &&
+            bb_equal( transform_board( state->black, symmetry ), state->black ) &&
+            bb_equal( transform_board( state->white, symmetry ), state->white ) )
+            symmetries[ count++ ] = symmetry;
+
+    if( count == 0 )
+        return;
+
+    int kept = 0;
+    for( int i = 0; i < moves->count; i++ )
+    {
+        int mirrored = 0;
+
+        for( int s = 0; s < count && !mirrored; s++ )
+        {
+            struct Move image = moves->moves[ i ];
+            transform_move( &image, symmetries[ s ] );
+
+            for( int j = 0; j < kept && !mirrored; j++ )
+                mirrored = compare_move( &image, &moves->moves[ j ] );
+        }
+
+        if( !mirrored )
+            moves->moves[ kept++ ] = moves->moves[ i ];
+    }
+
+    moves->count = kept;
+}
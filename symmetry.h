@@ -0,0 +1,43 @@
+/**
+ * @file symmetry.h
+ * @author Eric Watkins, Julian Martinez del Campo, Michael Hnatiw
+ *
+ * This file provides the symmetries of konane positions: a key shared by
+ * a position and its images, and the moves between their orientations
+ */
+#ifndef _SYMMETRY_H_
+#define _SYMMETRY_H_
+
+#include <stdint.h>
+
+#include "state.h"
+#include "move.h"
+
+void transform_move( struct Move * move, int symmetry );
+void remove_symmetric_moves( const struct State * state, struct MoveList * moves );
+
+/**
+ * Get the key a state shares with its images under every symmetry
+ *
+ * The state is keyed as its image with the lowest key, the canonical
+ * orientation. A move stored by that key must be moved by the same
+ * symmetry, both ways, as each symmetry undoes itself.
+ *
+ * @param state a state
+ * @param symmetry set to the symmetry taking the state to its canonical
+ *  orientation
+ * @return the key of the canonical orientation and the current player
+ */
+static inline uint64_t canonical_key( const struct State * state, int * symmetry )
+{
+    int best = IDENTITY;
+
+    for( int i = 1; i < SYMMETRIES; i++ )
+        if( state->hash[ i ] < state->hash[ best ] )
+            best = i;
+
+    *symmetry = best;
+    return state->hash[ best ] ^ ( state->player == 'W' ? zobrist_white_to_move : 0 );
+}
+
+#endif /* _SYMMETRY_H_ */
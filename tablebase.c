@@ -0,0 +1,193 @@
+/**
+ * @file tablebase.c
+ * @author Eric Watkins, Julian Martinez del Campo, Michael Hnatiw
+ *
+ * This file provides an implementation of tablebase.h
+ *
+ * The file is mapped read only, so loading it costs nothing until a probe
+ * touches a page, and the pages are shared by every engine that loads it.
+ */
+#define _POSIX_C_SOURCE 200809L
+
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "tablebase.h"
+#include "endgame.h"
+
+/** the mapped file, or null */
+static const unsigned char * tablebase = NULL;
+static size_t tablebase_length = 0;
+
+/** the window of the loaded tablebase */
+static int tb_rows;
+static int tb_cols;
+
+/** squares whose row plus column is even */
+static bitboard even_squares;
+
+/**
+ * Count the patterns of a window
+ *
+ * @param rows rows of the window
+ * @param cols columns of the window
+ * @return the number of patterns, of both parities
+ */
+size_t tablebase_patterns( int rows, int cols )
+{
+    return (size_t) 2 << ( rows * cols );
+}
+
+/**
+ * Number a pattern
+ *
+ * @param pieces the pieces, in a window at the top left of the board
+ * @param rows rows of the window
+ * @param cols columns of the window
+ * @param parity 0 if black's squares have even row plus column in the
+ *  window, 1 if odd
+ * @return the pattern's index
+ */
+size_t pattern_index( bitboard pieces, int rows, int cols, int parity )
+{
+    size_t index = 0;
+
+    for( int row = 0; row < rows; row++ )
+        index |= (size_t) bb_bits( pieces, row * SIZE, cols ) << ( row * cols );
+
+    return index | (size_t) parity << ( rows * cols );
+}
+
+/**
+ * Map a tablebase into memory
+ *
+ * @param path the tablebase file written by tbgen
+ * @return 1 if the tablebase was loaded, -1 if its windows do not fit on
+ * the board, else return 0
+ */
+int load_tablebase( const char * path )
+{
+    struct TablebaseHeader header;
+    struct stat status;
+    int fd = open( path, O_RDONLY );
+
+    if( fd < 0 )
+        return 0;
+
+    if( fstat( fd, &status ) != 0 ||
+        read( fd, &header, sizeof( header ) ) != sizeof( header ) ||
+        memcmp( header.magic, TB_MAGIC, sizeof( header.magic ) ) != 0 ||
+        header.rows < 1 || header.cols < 1 || header.rows * header.cols > TB_MAX_SQUARES ||
+        (size_t) status.st_size != sizeof( header ) + tablebase_patterns( header.rows, header.cols ) / 4 )
+    {
+        close( fd );
+        return 0;
+    }
+
+    if( header.rows > SIZE || header.cols > SIZE )
+    {
+        close( fd );
+        return -1;
+    }
+
+    void * map = mmap( NULL, status.st_size, PROT_READ, MAP_PRIVATE, fd, 0 );
+    close( fd );
+    if( map == MAP_FAILED )
+        return 0;
+
+    if( tablebase != NULL )
+        munmap( (void *) tablebase, tablebase_length );
+
+    tablebase = map;
+    tablebase_length = status.st_size;
+    tb_rows = header.rows;
+    tb_cols = header.cols;
+
+    even_squares = BB_EMPTY;
+    for( int row = 0; row < SIZE; row++ )
+        for( int col = row % 2; col < SIZE; col += 2 )
+            even_squares = bb_or( even_squares, BB_SQUARE( row, col ) );
+
+    return 1;
+}
+
+/**
+ * Check for a loaded tablebase
+ *
+ * @return 1 if a tablebase is loaded, else return 0
+ */
+int has_tablebase( void )
+{
+    return tablebase != NULL;
+}
+
+/**
+ * Look up the outcome of a region
+ *
+ * The region's play never leaves the squares it can reach. If those fit
+ * in the window, placed on the board, the region is played exactly as its
+ * pattern in the tablebase, where the window's edges are the board's.
+ *
+ * @param black the region's black pieces
+ * @param white the region's white pieces
+ * @param reach every square the region's pieces could reach
+ * @param player the player to move
+ * @return OUTCOME_WIN or OUTCOME_LOSS for the player to move, or
+ *  OUTCOME_UNKNOWN if the region does not fit the tablebase
+ */
+int probe_tablebase( bitboard black, bitboard white, bitboard reach, char player )
+{
+    int first_row = SIZE, last_row = -1;
+    int first_col = SIZE, last_col = -1;
+    bitboard cols = reach;
+
+    if( tablebase == NULL || bb_none( reach ) )
+        return OUTCOME_UNKNOWN;
+
+    for( int row = 0; row < SIZE; row++ )
+        if( bb_bits( reach, row * SIZE, SIZE ) )
+        {
+            if( first_row == SIZE )
+                first_row = row;
+            last_row = row;
+        }
+
+    for( int row = 1; row < SIZE; row++ )
+        cols = bb_or( cols, bb_shr( reach, row * SIZE ) );
+    for( int col = 0; col < SIZE; col++ )
+        if( bb_test( cols, col ) )
+        {
+            if( first_col == SIZE )
+                first_col = col;
+            last_col = col;
+        }
+
+    if( last_row - first_row >= tb_rows || last_col - first_col >= tb_cols )
+        return OUTCOME_UNKNOWN;
+
+    /* keep the window on the board, so it has no squares the region lacks */
+    if( first_row > SIZE - tb_rows )
+        first_row = SIZE - tb_rows;
+    if( first_col > SIZE - tb_cols )
+        first_col = SIZE - tb_cols;
+
+    /* black must hold squares of one colour and white the other */
+    int parity;
+    if( bb_none( bb_andnot( black, even_squares ) ) && bb_none( bb_and( white, even_squares ) ) )
+        parity = ( first_row + first_col ) % 2;
+    else if( bb_none( bb_and( black, even_squares ) ) && bb_none( bb_andnot( white, even_squares ) ) )
+        parity = ( first_row + first_col + 1 ) % 2;
+    else
+        return OUTCOME_UNKNOWN;
+
+    bitboard window = bb_shr( bb_or( black, white ), BB_INDEX( first_row, first_col ) );
+    size_t index = pattern_index( window, tb_rows, tb_cols, parity );
+    const unsigned char * outcomes = tablebase + sizeof( struct TablebaseHeader );
+    int outcome = ( outcomes[ index / 4 ] >> ( index % 4 * 2 ) ) & 3;
+    int wins = outcome & ( ( player == 'B' ) ? TB_BLACK_WINS : TB_WHITE_WINS );
+
+    return wins ? OUTCOME_WIN : OUTCOME_LOSS;
+}
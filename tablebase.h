@@ -0,0 +1,43 @@
+/**
+ * @file tablebase.h
+ * @author Eric Watkins, Julian Martinez del Campo, Michael Hnatiw
+ *
+ * This file provides an endgame tablebase: the outcome of every pattern of
+ * pieces in a small window of the board, worked out ahead of time by tbgen
+ * and mapped into memory by the engine
+ */
+#ifndef _TABLEBASE_H_
+#define _TABLEBASE_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "bitboard.h"
+
+#define TB_MAGIC "KONTB01"
+#define TB_MAX_SQUARES 28       /* most squares in a window */
+
+/** the start of a tablebase file, followed by the outcomes */
+struct TablebaseHeader {
+    char magic[ 8 ];    /**< TB_MAGIC */
+    int32_t rows;       /**< rows of the window */
+    int32_t cols;       /**< columns of the window */
+};
+
+/*
+ * A pattern is numbered by the squares of the window it fills, row by
+ * row, with one more bit for which squares are black's: those whose row
+ * plus column in the window is even, or odd. Its outcome takes two bits,
+ * bit 0 set if black wins moving first, bit 1 if white does.
+ */
+#define TB_BLACK_WINS 1
+#define TB_WHITE_WINS 2
+
+size_t tablebase_patterns( int rows, int cols );
+size_t pattern_index( bitboard pieces, int rows, int cols, int parity );
+
+int load_tablebase( const char * path );
+int has_tablebase( void );
+int probe_tablebase( bitboard black, bitboard white, bitboard reach, char player );
+
+#endif /* _TABLEBASE_H_ */
@@ -0,0 +1,187 @@
+/**
+ * @file tbgen.c
+ * @author Eric Watkins, Julian Martinez del Campo, Michael Hnatiw
+ *
+ * Generate an endgame tablebase: the outcome of every pattern of pieces in
+ * a window of the board, with the window's edges as the board's. Every
+ * move captures, so the patterns are solved in order of their number of
+ * pieces, and every pattern a move leads to is solved before the patterns
+ * it is reached from.
+ */
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "tablebase.h"
+#include "bitboard.h"
+#include "clock.h"
+#include "utility.h"
+
+/**
+ * Read a solved outcome
+ *
+ * @param outcomes the outcomes, two bits each
+ * @param index a pattern's index
+ * @return the pattern's outcome
+ */
+static int get_outcome( const unsigned char * outcomes, size_t index )
+{
+    return ( outcomes[ index / 4 ] >> ( index % 4 * 2 ) ) & 3;
+}
+
+/**
+ * Check whether a player wins moving first
+ *
+ * @param own the player's pieces
+ * @param other the opponent's pieces
+ * @param window the squares of the window
+ * @param rows rows of the window
+ * @param cols columns of the window
+ * @param black 1 if the player is black
+ * @param parity the parity of black's squares
+ * @param outcomes the outcomes of every pattern with fewer pieces
+ * @return 1 if some move leaves the opponent lost, else return 0
+ */
+static int wins_moving( bitboard own, bitboard other, bitboard window, int rows, int cols,
+                        int black, int parity, const unsigned char * outcomes )
+{
+    bitboard empty = bb_andnot( window, bb_or( own, other ) );
+    int opponent_wins = black ? TB_WHITE_WINS : TB_BLACK_WINS;
+
+    for( int direction = 0; direction < DIRECTIONS; direction++ )
+    {
+        int step = direction_offset[ direction ];
+        bitboard landings = jumps( own, other, empty, direction );
+
+        for( int length = 2; !bb_none( landings ); length += 2 )
+        {
+            bitboard current = landings;
+            while( !bb_none( current ) )
+            {
+                int end = pop_square( &current );
+                int start = end - length * step;
+                bitboard jumped = BB_EMPTY;
+
+                for( int jump = 1; jump < length; jump += 2 )
+                    jumped = bb_or( jumped, bb_square( start + jump * step ) );
+
+                bitboard moved = bb_xor( bb_square( start ), bb_square( end ) );
+                bitboard after = bb_or( bb_xor( own, moved ), bb_andnot( other, jumped ) );
+                size_t index = pattern_index( after, rows, cols, parity );
+
+                if( !( get_outcome( outcomes, index ) & opponent_wins ) )
+                    return 1;
+            }
+
+            /* continue each chain with another jump in the same direction */
+            landings = jumps( landings, other, empty, direction );
+        }
+    }
+
+    return 0;
+}
+
+int main( int argc, char * argv[] )
+{
+    if( argc != 4 )
+    {
+        printf( "%s usage: <output file> <rows> <columns>\n", argv[ 0 ] );
+        printf( "   output file - the tablebase to write\n" );
+        printf( "   rows, columns - the size of the window, at most %d squares\n", TB_MAX_SQUARES );
+        return EXIT_FAILURE;
+    }
+
+    int rows = atoi( argv[ 2 ] );
+    int cols = atoi( argv[ 3 ] );
+
+    if( rows < 1 || rows > SIZE || cols < 1 || cols > SIZE || rows * cols > TB_MAX_SQUARES )
+    {
+        printf( "the window must fit the board and have at most %d squares\n", TB_MAX_SQUARES );
+        return EXIT_FAILURE;
+    }
+
+    int squares = rows * cols;
+    size_t patterns = tablebase_patterns( rows, cols );
+    unsigned char * outcomes = Calloc( patterns / 4 + 1, 1 );
+    if( outcomes == NULL )
+    {
+        printf( "not enough memory for %zu patterns\n", patterns );
+        return EXIT_FAILURE;
+    }
+
+    /* the window's squares, and black's squares of each parity */
+    bitboard window = BB_EMPTY;
+    bitboard black_squares[ 2 ] = { BB_EMPTY, BB_EMPTY };
+    for( int row = 0; row < rows; row++ )
+        for( int col = 0; col < cols; col++ )
+        {
+            bitboard * parity = &black_squares[ ( row + col ) % 2 ];
+
+            window = bb_or( window, BB_SQUARE( row, col ) );
+            *parity = bb_or( *parity, BB_SQUARE( row, col ) );
+        }
+
+    millis start = clock_ms();
+
+    for( int pieces = 0; pieces <= squares; pieces++ )
+    {
+        /* every set of that many squares of the window, in increasing order */
+        for( uint64_t fill = ( (uint64_t) 1 << pieces ) - 1; fill < (uint64_t) 1 << squares; )
+        {
+            bitboard board = BB_EMPTY;
+            for( int bit = 0; bit < squares; bit++ )
+                if( ( fill >> bit ) & 1 )
+                    board = bb_or( board, BB_SQUARE( bit / cols, bit % cols ) );
+
+            for( int parity = 0; parity < 2; parity++ )
+            {
+                bitboard black = bb_and( board, black_squares[ parity ] );
+                bitboard white = bb_andnot( board, black_squares[ parity ] );
+                size_t index = pattern_index( board, rows, cols, parity );
+                int outcome = 0;
+
+                if( wins_moving( black, white, window, rows, cols, 1, parity, outcomes ) )
+                    outcome |= TB_BLACK_WINS;
+                if( wins_moving( white, black, window, rows, cols, 0, parity, outcomes ) )
+                    outcome |= TB_WHITE_WINS;
+
+                outcomes[ index / 4 ] |= outcome << ( index % 4 * 2 );
+            }
+
+            if( fill == 0 )
+                break;
+
+            /* the next larger number with as many bits set */
+            uint64_t low = fill & -fill;
+            uint64_t ripple = fill + low;
+            fill = ripple | ( ( ( fill ^ ripple ) >> 2 ) / low );
+        }
+    }
+
+    struct TablebaseHeader header;
+    memset( &header, 0, sizeof( header ) );
+    memcpy( header.magic, TB_MAGIC, sizeof( header.magic ) );
+    header.rows = rows;
+    header.cols = cols;
+
+    FILE * file = fopen( argv[ 1 ], "wb" );
+    if( file == NULL ||
+        fwrite( &header, sizeof( header ), 1, file ) != 1 ||
+        fwrite( outcomes, 1, patterns / 4, file ) != patterns / 4 ||
+        fclose( file ) != 0 )
+    {
+        printf( "could not write %s\n", argv[ 1 ] );
+        return EXIT_FAILURE;
+    }
+
+    printf( "Window: %d x %d\n", rows, cols );
+    printf( "Patterns: %zu\n", patterns );
+    printf( "Size: %zu bytes\n", sizeof( header ) + patterns / 4 );
+    printf( "Time: %.3f s\n", ( clock_ms() - start ) / 1000.0 );
+
+    Free( outcomes );
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,127 @@
+/**
+ * @file timeman.c
+ * @author Eric Watkins, Julian Martinez del Campo, Michael Hnatiw
+ *
+ * This file provides an implementation of timeman.h
+ *
+ * With a game clock, each move gets the time left divided by an estimate
+ * of the moves left plus the increment (the soft budget), and may run to
+ * HARD_FACTOR times that (the hard budget). Each move captures at least
+ * one piece, so the moves left are estimated from the pieces on the board.
+ */
+#include "timeman.h"
+#include "bitboard.h"
+
+#define HARD_FACTOR 4       /* hard budget as a multiple of the soft budget */
+#define PIECES_PER_MOVE 4   /* pieces taken off the board per move of one player */
+#define MIN_MOVES_LEFT 4    /* fewest moves left assumed */
+#define STABLE_ITERATIONS 3 /* iterations with the same best move to stop early */
+#define SCORE_DROP 3        /* score loss since the last iteration to take more time */
+
+/**
+ * Set up a time manager
+ *
+ * @param manager a time manager
+ * @param game_clock 1 if time is for the whole game, 0 if it is per move
+ * @param time the time for the game or for each move
+ * @param increment time added to the game clock after each move
+ */
+void init_time_manager( struct TimeManager * manager, int game_clock, millis time,
+                        millis increment )
+{
+    manager->game_clock = game_clock;
+    manager->remaining = time;
+    manager->increment = game_clock ? increment : 0;
+    manager->start = 0;
+    manager->soft = 0;
+    manager->hard = 0;
+}
+
+/**
+ * Start timing a move and set its budgets
+ *
+ * @param manager a time manager
+ * @param state the state the move is made from
+ */
+void start_move( struct TimeManager * manager, const struct State * state )
+{
+    manager->start = clock_ms();
+
+    if( !manager->game_clock )
+    {
+        millis budget = manager->remaining - MOVE_OVERHEAD;
+
+        /* a move time near the overhead still searches half of it */
+        if( budget < manager->remaining / 2 )
+            budget = manager->remaining / 2;
+        if( budget < 1 )
+            budget = 1;
+
+        manager->soft = manager->hard = budget;
+        return;
+    }
+
+    int moves_left = popcount( bb_or( state->black, state->white ) ) / PIECES_PER_MOVE;
+    if( moves_left < MIN_MOVES_LEFT )
+        moves_left = MIN_MOVES_LEFT;
+
+    millis available = manager->remaining - MOVE_OVERHEAD;
+
+    manager->soft = available / moves_left + manager->increment;
+    manager->hard = manager->soft * HARD_FACTOR;
+
+    /* never plan to use more than half of what is left */
+    if( manager->hard > available / 2 + manager->increment )
+        manager->hard = available / 2 + manager->increment;
+    if( manager->soft > manager->hard )
+        manager->soft = manager->hard;
+    if( manager->hard < 1 )
+        manager->soft = manager->hard = 1;
+}
+
+/**
+ * Check if another iteration should be started
+ *
+ * A best move that has not changed for a few iterations halves the soft
+ * budget, and a falling score doubles it.
+ *
+ * @param manager a time manager
+ * @param stable iterations the best move has stayed the same
+ * @param score_drop how much the score fell in the last iteration
+ * @return 1 if there is time for another iteration, else return 0
+ */
+int continue_search( const struct TimeManager * manager, int stable, int score_drop )
+{
+    millis budget = manager->soft;
+
+    if( stable >= STABLE_ITERATIONS )
+        budget /= 2;
+    if( score_drop >= SCORE_DROP )
+        budget *= 2;
+    if( budget > manager->hard )
+        budget = manager->hard;
+
+    return clock_ms() - manager->start < budget;
+}
+
+/**
+ * Get the time the current move must be made by
+ *
+ * @param manager a time manager
+ * @return the deadline, from clock_ms()
+ */
+millis move_deadline( const struct TimeManager * manager )
+{
+    return manager->start + manager->hard;
+}
+
+/**
+ * Charge the time of the current move to the game clock
+ *
+ * @param manager a time manager
+ */
+void end_move( struct TimeManager * manager )
+{
+    if( manager->game_clock )
+        manager->remaining += manager->increment - ( clock_ms() - manager->start );
+}
@@ -0,0 +1,34 @@
+/**
+ * @file timeman.h
+ * @author Eric Watkins, Julian Martinez del Campo, Michael Hnatiw
+ *
+ * This file provides time management: how long the computer player may
+ * think about each move, from a game clock or a fixed time per move
+ */
+#ifndef _TIMEMAN_H_
+#define _TIMEMAN_H_
+
+#include "clock.h"
+#include "state.h"
+
+/** time kept back on every move to return it, in milliseconds */
+#define MOVE_OVERHEAD 50
+
+/** the computer player's clock */
+struct TimeManager {
+    int game_clock;     /**< 1 if the time is for the whole game, 0 if per move */
+    millis remaining;   /**< time left on the game clock, or the time per move */
+    millis increment;   /**< time added to the game clock after each move */
+    millis start;       /**< when the current move started */
+    millis soft;        /**< time after which no new iteration is started */
+    millis hard;        /**< time after which the search is stopped */
+};
+
+void init_time_manager( struct TimeManager * manager, int game_clock, millis time,
+                        millis increment );
+void start_move( struct TimeManager * manager, const struct State * state );
+int continue_search( const struct TimeManager * manager, int stable, int score_drop );
+millis move_deadline( const struct TimeManager * manager );
+void end_move( struct TimeManager * manager );
+
+#endif /* _TIMEMAN_H_ */
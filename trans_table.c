@@ -0,0 +1,241 @@
+/**
+ * @file trans_table.c
+ * @author Eric Watkins, Julian Martinez del Campo, Michael Hnatiw
+ *
+ * This file provides an implementation of trans_table.h
+ *
+ * A transposition is packed into 64 bits: score in bits 0-15, depth in bits
+ * 16-23, bound in bits 24-25, the has move flag in bit 26, and the move's
+ * start and end squares in bits 32-39 and 40-47. The generation of the
+ * search that stored it is in bits 48-55. An entry with no bound is empty.
+ *
+ * Search threads share the table without locks. An entry's key is stored
+ * xored with its data, so an entry torn by two threads writing at once no
+ * longer matches either key and is treated as missing.
+ */
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+
+#include "trans_table.h"
+#include "utility.h"
+
+#define DEPTH_SHIFT 16
+#define BOUND_SHIFT 24
+#define MOVE_SHIFT  26
+#define START_SHIFT 32
+#define END_SHIFT   40
+#define AGE_SHIFT   48
+
+#define AGE_PENALTY 2   /* plies an entry's depth counts for less per generation */
+
+/**
+ * Pack a transposition
+ *
+ * @param entry a transposition
+ * @return the packed transposition
+ */
+static uint64_t pack( const struct Transposition * entry )
+{
+    uint64_t data = (uint16_t) ( entry->score + 32768 );
+
+    data |= (uint64_t) ( entry->depth & 0xFF ) << DEPTH_SHIFT;
+    data |= (uint64_t) ( entry->bound & 0x3 ) << BOUND_SHIFT;
+
+    if( entry->has_move )
+    {
+        data |= (uint64_t) 1 << MOVE_SHIFT;
+        data |= (uint64_t) BB_INDEX( entry->move.start_row, entry->move.start_col ) << START_SHIFT;
+        data |= (uint64_t) BB_INDEX( entry->move.end_row, entry->move.end_col ) << END_SHIFT;
+    }
+
+    return data;
+}
+
+/**
+ * Unpack a transposition
+ *
+ * @param data a packed transposition
+ * @param entry set to the transposition
+ */
+static void unpack( uint64_t data, struct Transposition * entry )
+{
+    int start = ( data >> START_SHIFT ) & 0xFF;
+    int end = ( data >> END_SHIFT ) & 0xFF;
+
+    entry->score = (int) ( data & 0xFFFF ) - 32768;
+    entry->depth = ( data >> DEPTH_SHIFT ) & 0xFF;
+    entry->bound = ( data >> BOUND_SHIFT ) & 0x3;
+    entry->has_move = ( data >> MOVE_SHIFT ) & 1;
+    entry->move.start_row = start / SIZE;
+    entry->move.start_col = start % SIZE;
+    entry->move.end_row = end / SIZE;
+    entry->move.end_col = end % SIZE;
+}
+
+/**
+ * Read an entry
+ *
+ * @param entry an entry
+ * @param data set to the entry's packed transposition
+ * @return the key of the entry's position
+ */
+static uint64_t read_entry( const struct TransEntry * entry, uint64_t * data )
+{
+    uint64_t key = __atomic_load_n( &entry->key, __ATOMIC_RELAXED );
+
+    *data = __atomic_load_n( &entry->data, __ATOMIC_RELAXED );
+    return key ^ *data;
+}
+
+/**
+ * Write an entry
+ *
+ * @param entry an entry
+ * @param key the key of the position
+ * @param data the packed transposition
+ */
+static void write_entry( struct TransEntry * entry, uint64_t key, uint64_t data )
+{
+    __atomic_store_n( &entry->key, key ^ data, __ATOMIC_RELAXED );
+    __atomic_store_n( &entry->data, data, __ATOMIC_RELAXED );
+}
+
+/**
+ * Create a new transposition table
+ *
+ * @param megabytes the most memory the entries may use
+ * @return a new empty table, with a power of two number of buckets, or
+ * null if it does not fit in the memory limit
+ */
+struct TransTable * new_trans_table( size_t megabytes )
+{
+    struct TransTable * table = Calloc( 1, sizeof( struct TransTable ) );
+    if( table == NULL )
+        return NULL;
+
+    size_t bucket_size = 2 * sizeof( struct TransEntry );
+    table->buckets = 1;
+    while( table->buckets * 2 * bucket_size <= megabytes * 1024 * 1024 )
+        table->buckets *= 2;
+
+    table->entries = Calloc( table->buckets * 2, sizeof( struct TransEntry ) );
+    if( table->entries == NULL )
+    {
+        Free( table );
+        return NULL;
+    }
+
+    return table;
+}
+
+/**
+ * Delete a transposition table
+ *
+ * @param table a table to destroy
+ */
+void delete_trans_table( struct TransTable ** table )
+{
+    Free( (*table)->entries );
+    Free( *table );
+    *table = NULL;
+}
+
+/**
+ * Empty a transposition table
+ *
+ * @param table a table to clear
+ */
+void clear_trans_table( struct TransTable * table )
+{
+    memset( table->entries, 0, table->buckets * 2 * sizeof( struct TransEntry ) );
+}
+
+/**
+ * Start a new generation of entries
+ *
+ * Entries stored before are still found, but give way to new ones. The
+ * table is aged before each move, so it keeps what earlier moves learned
+ * without filling up with positions that can no longer be reached.
+ *
+ * @param table a table
+ */
+void age_trans_table( struct TransTable * table )
+{
+    table->generation = ( table->generation + 1 ) & 0xFF;
+}
+
+/**
+ * Look up a position
+ *
+ * @param table a table
+ * @param key the position's zobrist key
+ * @param entry set to the stored transposition, if found
+ * @return 1 if the position was found, else return 0
+ */
+int probe_trans_table( const struct TransTable * table, uint64_t key, struct Transposition * entry )
+{
+    const struct TransEntry * bucket = &table->entries[ ( key & ( table->buckets - 1 ) ) * 2 ];
+    uint64_t data;
+
+    for( int i = 0; i < 2; i++ )
+        if( read_entry( &bucket[ i ], &data ) == key && data != 0 )
+        {
+            unpack( data, entry );
+            return 1;
+        }
+
+    return 0;
+}
+
+/**
+ * Store a position
+ *
+ * The first entry of a bucket keeps the deepest search of this generation,
+ * the second takes whatever the first turns away.
+ *
+ * @param table a table
+ * @param key the position's zobrist key
+ * @param entry the transposition to store
+ */
+void store_trans_table( struct TransTable * table, uint64_t key, const struct Transposition * entry )
+{
+    struct TransEntry * bucket = &table->entries[ ( key & ( table->buckets - 1 ) ) * 2 ];
+    struct Transposition stored = *entry;
+    struct Transposition old;
+    uint64_t keys[ 2 ];
+    uint64_t data[ 2 ];
+    int slot;
+
+    keys[ 0 ] = read_entry( &bucket[ 0 ], &data[ 0 ] );
+    keys[ 1 ] = read_entry( &bucket[ 1 ], &data[ 1 ] );
+
+    if( keys[ 0 ] == key )
+        slot = 0;
+    else if( keys[ 1 ] == key )
+        slot = 1;
+    else
+    {
+        unpack( data[ 0 ], &old );
+        int age = ( table->generation - ( data[ 0 ] >> AGE_SHIFT ) ) & 0xFF;
+        if( data[ 0 ] == 0 || entry->depth >= old.depth - AGE_PENALTY * age )
+        {
+            write_entry( &bucket[ 1 ], keys[ 0 ], data[ 0 ] );
+            keys[ 1 ] = keys[ 0 ];
+            data[ 1 ] = data[ 0 ];
+            slot = 0;
+        }
+        else
+            slot = 1;
+    }
+
+    /* keep the best move of an earlier search of the same position */
+    if( !stored.has_move && keys[ slot ] == key && data[ slot ] != 0 )
+    {
+        unpack( data[ slot ], &old );
+        stored.has_move = old.has_move;
+        stored.move = old.move;
+    }
+
+    write_entry( &bucket[ slot ], key, pack( &stored ) | (uint64_t) table->generation << AGE_SHIFT );
+}
@@ -0,0 +1,52 @@
+/**
+ * @file trans_table.h
+ * @author Eric Watkins, Julian Martinez del Campo, Michael Hnatiw
+ *
+ * This file provides a fixed size transposition table for the search
+ */
+#ifndef _TRANS_TABLE_H_
+#define _TRANS_TABLE_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "move.h"
+
+/** how a stored score bounds the true score */
+enum Bound {
+    BOUND_EXACT = 1,    /**< the score is exact */
+    BOUND_LOWER,        /**< the true score is at least the score */
+    BOUND_UPPER         /**< the true score is at most the score */
+};
+
+/** a position's search result */
+struct Transposition {
+    int depth;          /**< plies searched below the position */
+    int bound;          /**< how score bounds the true score */
+    int score;          /**< score from the current player's view */
+    int has_move;       /**< 1 if move holds the best move found */
+    struct Move move;   /**< best move found */
+};
+
+/** a stored transposition, packed with its full key */
+struct TransEntry {
+    uint64_t key;       /**< zobrist key of the position xor data */
+    uint64_t data;      /**< packed struct Transposition */
+};
+
+/** a transposition table of two entry buckets */
+struct TransTable {
+    struct TransEntry * entries;    /**< bucket i is entries 2i and 2i+1 */
+    size_t buckets;                 /**< number of buckets, a power of two */
+    unsigned generation;            /**< age given to new entries, below 256 */
+};
+
+struct TransTable * new_trans_table( size_t megabytes );
+void delete_trans_table( struct TransTable ** table );
+void clear_trans_table( struct TransTable * table );
+void age_trans_table( struct TransTable * table );
+
+int probe_trans_table( const struct TransTable * table, uint64_t key, struct Transposition * entry );
+void store_trans_table( struct TransTable * table, uint64_t key, const struct Transposition * entry );
+
+#endif /* _TRANS_TABLE_H_ */
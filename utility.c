@@ -7,8 +7,6 @@
 #include <stdlib.h>
 #include "utility.h"
 
-static unsigned long _memory_usage = 0;
-
 /**
  * setup_board
  *
@@ -28,67 +26,33 @@ void setup_board(char *filename, char board[][SIZE])
   }
 
   /* iterate through file to fill initial board state */
-  char c;
-  int x = 0, y = 0;
-  while((c = fgetc(fh)) != EOF){
+  int c;
+  int x = 0, y = 0, fits = 1;
+  while((c = fgetc(fh)) != EOF && fits){
     if(c == '\n'){
-      x++;
+      if(y > 0){
+        fits = (y == SIZE);
+        x++;
+      }
       y = 0;
       continue;
     }
-    board[x][y] = c;
+    fits = (x < SIZE && y < SIZE);
+    if(fits)
+      board[x][y] = c;
     y++;
   }
   
   fclose(fh);
-}
 
+  if(y > 0){
+    fits = fits && (y == SIZE);
+    x++;
+  }
 
-/**
- * Calloc
- *
- * This funciton is a wrapper to calloc. It checks that memory was
- *  properly allocated, and tracks memory usage
- *
- * @param the number of elements in the array
- * @param size the size of the element
- * @return a pointer to the allocated memory
- */
-void * Calloc( size_t nmemb, size_t size )
-{
-  _memory_usage += (nmemb * size);
-
-  return calloc( nmemb, size );
-}
-
-/**
- * Free memory
- *
- * Frees memory, and decreases the memory usage tracked accordingly
- *
- * @param ptr to memory to free
- * @param size the size of the memory to free
- */
-void Free( void * ptr, size_t size )
-{
-    /* WARNING! UGLY HACK! TRACK DOWN ACTUAL PROBLEM
-     * to stop negative sizes check if subtracting size
-     * from memory would result in negative value
-     */
-    if( _memory_usage < size )
-        _memory_usage = 0;
-    else
-        _memory_usage -= size;
-
-  free( ptr );
-}
-
-/**
- * Get the memory used by the program
- *
- * @return the memory used, in bytes
- */
-unsigned long memory_usage( void )
-{
-  return _memory_usage;
+  /* main.c and dispatch.c chose the build of this size for the board */
+  if(!fits || x != SIZE){
+    printf("%s is not a %dx%d board\n", filename, SIZE, SIZE);
+    exit(EXIT_FAILURE);
+  }
 }
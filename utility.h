@@ -1,6 +1,6 @@
 /**
  * @file utility.h
- * @brief this file provides memory allocation routines, and memory tracking functions
+ * @brief this file provides the board file reader, and the memory routines of memory.h
  * @author Eric Watkins, Julian Martinez del Campo, Michael Hnatiw
  */
 #ifndef _UTILITY_H_
@@ -8,12 +8,9 @@
 
 #include <stdlib.h>
 
-#define SIZE 8
+#include "bitboard.h"
+#include "memory.h"
 
 void setup_board(char *filename,char board[][SIZE]);
 
-void * Calloc( size_t nmemb, size_t size );
-void Free( void * ptr, size_t size );
-unsigned long memory_usage( void );
-
 #endif /* _UTILITY_H_ */
@@ -0,0 +1,74 @@
+/**
+ * @file zobrist.c
+ * @author Eric Watkins, Julian Martinez del Campo, Michael Hnatiw
+ *
+ * This file provides an implementation of zobrist.h
+ */
+#include "zobrist.h"
+
+uint64_t zobrist_pieces[ 2 ][ SIZE * SIZE ][ SYMMETRIES ];
+uint64_t zobrist_white_to_move;
+
+static int initialized = 0;
+
+/**
+ * Generate the next pseudo random key
+ *
+ * A fixed seed is used so keys, and anything stored by key, are the same
+ * in every run.
+ *
+ * @param seed the generator state, advanced by each call
+ * @return a pseudo random 64-bit value
+ */
+static uint64_t next_key( uint64_t * seed )
+{
+    uint64_t z = ( *seed += 0x9E3779B97F4A7C15ULL );
+    z = ( z ^ ( z >> 30 ) ) * 0xBF58476D1CE4E5B9ULL;
+    z = ( z ^ ( z >> 27 ) ) * 0x94D049BB133111EBULL;
+    return z ^ ( z >> 31 );
+}
+
+/**
+ * Fill the key tables, once
+ */
+void init_zobrist( void )
+{
+    uint64_t seed = 0x4B6F6E616E65ULL;
+
+    if( initialized )
+        return;
+
+    for( int color = 0; color < 2; color++ )
+        for( int square = 0; square < SIZE * SIZE; square++ )
+            zobrist_pieces[ color ][ square ][ IDENTITY ] = next_key( &seed );
+
+    zobrist_white_to_move = next_key( &seed );
+
+    for( int symmetry = 1; symmetry < SYMMETRIES; symmetry++ )
+        for( int color = 0; color < 2; color++ )
+            for( int square = 0; square < SIZE * SIZE; square++ )
+                zobrist_pieces[ color ][ square ][ symmetry ] =
+                    zobrist_pieces[ color ][ symmetric_square( square, symmetry ) ][ IDENTITY ];
+    initialized = 1;
+}
+
+/**
+ * Hash a set of pieces from scratch
+ *
+ * @param black squares holding black pieces
+ * @param white squares holding white pieces
+ * @return the xor of the keys of every piece
+ */
+uint64_t hash_pieces( bitboard black, bitboard white )
+{
+    uint64_t hash = 0;
+
+    init_zobrist();
+
+    while( !bb_none( black ) )
+        hash ^= zobrist_pieces[ 0 ][ pop_square( &black ) ][ IDENTITY ];
+    while( !bb_none( white ) )
+        hash ^= zobrist_pieces[ 1 ][ pop_square( &white ) ][ IDENTITY ];
+
+    return hash;
+}
@@ -0,0 +1,42 @@
+/**
+ * @file zobrist.h
+ * @author Eric Watkins, Julian Martinez del Campo, Michael Hnatiw
+ *
+ * This file provides zobrist keys for hashing konane states
+ */
+#ifndef _ZOBRIST_H_
+#define _ZOBRIST_H_
+
+#include <stdint.h>
+
+#include "bitboard.h"
+
+/**
+ * key of a piece on a square, indexed by [ white ][ square ][ symmetry ]:
+ * the key of the piece on the square the symmetry moves it to
+ */
+extern uint64_t zobrist_pieces[ 2 ][ SIZE * SIZE ][ SYMMETRIES ];
+/** key added when white is to move */
+extern uint64_t zobrist_white_to_move;
+
+void init_zobrist( void );
+uint64_t hash_pieces( bitboard black, bitboard white );
+
+/**
+ * Add or remove a piece on a square in the keys of a position
+ *
+ * @param hash the position's key under each symmetry
+ * @param piece B or W
+ * @param square the square index
+ */
+static inline void toggle_piece( uint64_t hash[ SYMMETRIES ], char piece, int square )
+{
+    const uint64_t * keys = zobrist_pieces[ piece == 'W' ][ square ];
+
+    hash[ IDENTITY ] ^= keys[ IDENTITY ];
+    hash[ ROTATE_HALF ] ^= keys[ ROTATE_HALF ];
+    hash[ FLIP_DIAGONAL ] ^= keys[ FLIP_DIAGONAL ];
+    hash[ FLIP_ANTIDIAGONAL ] ^= keys[ FLIP_ANTIDIAGONAL ];
+}
+
+#endif /* _ZOBRIST_H_ */